@@ -1,5 +1,132 @@
 #include "S32K144.h"
+#include "s32_core_cm4.h" // REV_BYTES_32
+#include <stddef.h>
+#include <string.h>
+#include <interrupt_manager.h>
 #include <FlexCan.h>
+#include "can_timing.h"
+
+/* Reject unreachable bit timings at build time */
+CAN_TIMING_CHECK(FLEXCAN0_CLK_HZ, FLEXCAN0_BITRATE, FLEXCAN0_SAMPLE_POINT, FLEXCAN0_CLK_TOL_PPM);
+#if FLEXCAN0_FD_ENABLE
+CAN_TIMING_FD_CHECK(FLEXCAN0_CLK_HZ, FLEXCAN0_FD_BITRATE, FLEXCAN0_FD_SAMPLE_POINT);
+#endif
+
+/* Single-producer (RX ISR) / single-consumer (main loop) frame ring */
+static flexcan_frame_t s_rx_ring[FLEXCAN0_RX_RING_SIZE];
+static volatile uint32_t s_rx_head = 0; // written only by the ISR
+static volatile uint32_t s_rx_tail = 0; // written only by the main loop
+static volatile flexcan_rx_overrun_t s_rx_overrun = {0, 0};
+static flexcan_frame_t s_rx_dropped; // Scratch slot used while the ring is full
+
+#if FLEXCAN0_RX_FIFO_ENABLE
+static const uint32_t s_rx_fifo_ids[] = FLEXCAN0_RX_FIFO_IDS;
+#define RX_FIFO_ID_COUNT (sizeof(s_rx_fifo_ids) / sizeof(s_rx_fifo_ids[0]))
+#endif
+
+volatile flexcan_seq_stats_t g_flexcan0_seq_stats = {0, 0, 0, 0};
+
+#if FLEXCAN0_SEQ_HEADER_ENABLE
+static uint8_t s_tx_seq = 0;        // Number stamped on the next transmitted frame
+static uint8_t s_rx_seq = 0;        // Number expected on the next received frame
+static bool s_rx_seq_valid = false; // false until the first header has been seen
+#endif
+
+/* Last extended timer value, a single word so ISR and main loop can both update it */
+static volatile uint32_t s_time_ext = 0;
+
+/* Keep the compiler and the core from reordering ring data and index accesses
+ * (host builds, tests/, provide their own) */
+#ifndef RING_BARRIER
+#define RING_BARRIER() __asm volatile ("dmb" : : : "memory")
+#endif
+
+/* Payload length for each DLC code (CAN FD table, classic uses 0..8) */
+static const uint8_t s_dlc_to_len[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+
+#if FLEXCAN0_FD_ENABLE
+#define FLEXCAN0_MAX_DLC  (15U)
+#else
+#define FLEXCAN0_MAX_DLC  (8U)
+#endif
+
+/*
+ * Smallest DLC that carries length bytes, limited to the mailbox size.
+ */
+static uint8_t FLEXCAN0_len_to_dlc(uint32_t length) {
+    uint8_t dlc = 0;
+
+    if (length > FLEXCAN0_PAYLOAD_SIZE) {
+        length = FLEXCAN0_PAYLOAD_SIZE;
+    }
+    while ((dlc < FLEXCAN0_MAX_DLC) && (s_dlc_to_len[dlc] < length)) {
+        dlc++;
+    }
+    return dlc;
+}
+
+/*
+ * Copy a payload into mailbox data words. FlexCAN stores byte 0 in the most
+ * significant byte of each word, so every word is byte reversed once.
+ * Bytes between length and the DLC size are sent as 0.
+ */
+static void FLEXCAN0_write_payload(uint32_t mb, const uint8_t *data, uint32_t length, uint32_t dlcLength) {
+    volatile uint32_t *mbData = &CAN0->RAMn[mb * MSG_BUF_SIZE + 2];
+    uint32_t words = (dlcLength + 3U) >> 2;
+    uint32_t w;
+
+    for (w = 0; w < words; w++) {
+        uint32_t x = 0;
+        uint32_t y;
+        uint32_t offset = w << 2;
+
+        if ((offset + 4U) <= length) {
+            memcpy(&x, &data[offset], 4U);
+        } else if (offset < length) {
+            memcpy(&x, &data[offset], length - offset);
+        }
+        REV_BYTES_32(x, y);
+        mbData[w] = y;
+    }
+}
+
+/*
+ * Copy length bytes of mailbox data words into data (whole words, so data
+ * must hold at least length rounded up to 4 bytes).
+ */
+static void FLEXCAN0_read_payload(uint32_t mb, uint8_t *data, uint32_t length) {
+    volatile const uint32_t *mbData = &CAN0->RAMn[mb * MSG_BUF_SIZE + 2];
+    uint32_t words = (length + 3U) >> 2;
+    uint32_t w;
+
+    for (w = 0; w < words; w++) {
+        uint32_t x = mbData[w];
+        uint32_t y;
+        REV_BYTES_32(x, y);
+        memcpy(&data[w << 2], &y, 4U);
+    }
+}
+
+/*
+ * Advance the extended time to the 16-bit timer value now16, assuming less
+ * than one wrap has passed since the last update. A racing update from
+ * another context stores an equally valid value, so no lock is needed.
+ */
+static uint32_t FLEXCAN0_time_update(uint16_t now16) {
+
+    uint32_t last = s_time_ext;
+    uint32_t now = last + (uint16_t)(now16 - (uint16_t)last);
+
+    s_time_ext = now;
+    return now;
+}
+
+/*
+ * Extend a 16-bit stamp taken at most one wrap before now.
+ */
+static uint32_t FLEXCAN0_time_extend(uint16_t stamp, uint32_t now) {
+    return now - (uint16_t)((uint16_t)now - stamp);
+}
 
 /**
  * Initialize the FLEXCAN0 module for 500 kbps communication.
@@ -9,13 +136,27 @@ void FLEXCAN0_init(void) {
     PCC->PCCn[PCC_FlexCAN0_INDEX] |= PCC_PCCn_CGC_MASK;
 
     CAN0->MCR |= CAN_MCR_MDIS_MASK;
-    CAN0->CTRL1 &= ~CAN_CTRL1_CLKSRC_MASK;
+    CAN0->CTRL1 = (CAN0->CTRL1 & ~CAN_CTRL1_CLKSRC_MASK) | CAN_CTRL1_CLKSRC(FLEXCAN0_CLK_SRC); // only writable while disabled
     CAN0->MCR |= (CAN_MCR_FRZ_MASK | CAN_MCR_HALT_MASK);
 
     CAN0->MCR &= ~CAN_MCR_MDIS_MASK;
     while (!((CAN0->MCR & CAN_MCR_FRZACK_MASK) >> CAN_MCR_FRZACK_SHIFT)) {}
 
-    CAN0->CTRL1 = 0x00DB0006;  // Set CAN baud rate to 500 kbps (based on 8 MHz clock)
+    /* FLEXCAN0_BITRATE from FLEXCAN0_CLK_HZ (500 kbps from 8 MHz gives 0x00DB0006) */
+    CAN0->CTRL1 = CAN_TIMING_CTRL1(FLEXCAN0_CLK_SRC, FLEXCAN0_CLK_HZ, FLEXCAN0_BITRATE, FLEXCAN0_SAMPLE_POINT);
+
+#if FLEXCAN0_FD_ENABLE
+    /* Nominal phase through CBT (same segments as CTRL1 above), data phase FLEXCAN0_FD_BITRATE */
+    CAN0->MCR |= CAN_MCR_FDEN_MASK;
+    CAN0->MCR = (CAN0->MCR & ~CAN_MCR_MAXMB_MASK) | CAN_MCR_MAXMB(FLEXCAN0_MB_COUNT - 1UL);
+    CAN0->CBT = CAN_TIMING_CBT(FLEXCAN0_CLK_HZ, FLEXCAN0_BITRATE, FLEXCAN0_SAMPLE_POINT);
+    CAN0->FDCBT = CAN_TIMING_FDCBT(FLEXCAN0_CLK_HZ, FLEXCAN0_FD_BITRATE, FLEXCAN0_FD_SAMPLE_POINT);
+    /* MBDSR0: 0 = 8, 1 = 16, 2 = 32, 3 = 64 bytes per mailbox */
+    CAN0->FDCTRL = CAN_FDCTRL_FDRATE_MASK |
+                   CAN_FDCTRL_MBDSR0((FLEXCAN0_PAYLOAD_SIZE == 8UL)  ? 0UL :
+                                     (FLEXCAN0_PAYLOAD_SIZE == 16UL) ? 1UL :
+                                     (FLEXCAN0_PAYLOAD_SIZE == 32UL) ? 2UL : 3UL);
+#endif
 
     uint32_t i = 0;
     for (i = 0; i < 128; i++) CAN0->RAMn[i] = 0;
@@ -23,61 +164,335 @@ void FLEXCAN0_init(void) {
     for (i = 0; i < 16; i++)  CAN0->RXIMR[i] = 0xFFFFFFFF;
 
     CAN0->RXMGMASK = 0x1FFFFFFF;
+#if FLEXCAN0_RX_FIFO_ENABLE
+    /* RX FIFO with 8 format A filter elements (RFFN = 0). Unused elements
+     * repeat the last accepted ID, all ID bits are compared. */
+    CAN0->MCR |= CAN_MCR_RFEN_MASK;
+    CAN0->CTRL2 = (CAN0->CTRL2 & ~CAN_CTRL2_RFFN_MASK) | CAN_CTRL2_RFFN(0);
+    CAN0->RXFGMASK = 0xFFFFFFFF;
+    for (i = 0; i < FIFO_FILTER_COUNT; i++) {
+        uint32_t id = s_rx_fifo_ids[(i < RX_FIFO_ID_COUNT) ? i : (RX_FIFO_ID_COUNT - 1)];
+        CAN0->RAMn[FIFO_FILTER_WORD + i] = (id & 0x7FFUL) << 19; // RTR = 0, IDE = 0
+    }
+#else
     CAN0->RAMn[RX_MAILBOX * MSG_BUF_SIZE + 1] = RX_MSG_ID << 18;
     CAN0->RAMn[RX_MAILBOX * MSG_BUF_SIZE + 0] = 0x04000000; // CODE=4 (RX inactive)
+#endif
 
+    s_time_ext = 0;
+#if FLEXCAN0_SEQ_HEADER_ENABLE
+    s_tx_seq = 0;
+    s_rx_seq_valid = false;
+#endif
     CAN0->MCR &= ~(CAN_MCR_FRZ_MASK | CAN_MCR_HALT_MASK);
     while ((CAN0->MCR & CAN_MCR_FRZACK_MASK) >> CAN_MCR_FRZACK_SHIFT) {}
     while ((CAN0->MCR & CAN_MCR_NOTRDY_MASK) >> CAN_MCR_NOTRDY_SHIFT) {}
 }
 
+/**
+ * Current FlexCAN time, extended to 32 bits.
+ * Reading TIMER also unlocks any locked mailbox, so do not call this while
+ * a mailbox is being read.
+ *
+ * @return uint32_t Time in FLEXCAN0_TIMER_HZ ticks.
+ */
+uint32_t FLEXCAN0_get_time(void) {
+    return FLEXCAN0_time_update((uint16_t)CAN0->TIMER);
+}
+
 /*
- * Transmit a 4-byte CAN message using FLEXCAN0 TX MailBox.
+ * Transmit a CAN message using FLEXCAN0 TX MailBox.
  *
- * @param buffer Pointer to 4-byte array containing the message data.
+ * @param buffer Pointer to the message data.
+ * @param length Number of bytes (up to FLEXCAN0_PAYLOAD_SIZE, one less
+ *               with FLEXCAN0_SEQ_HEADER_ENABLE).
  */
-void FLEXCAN0_transmit_msg(uint8_t *buffer) {
+void FLEXCAN0_transmit_msg(const uint8_t *buffer, uint8_t length) {
+
+#if FLEXCAN0_SEQ_HEADER_ENABLE
+    uint8_t staged[FLEXCAN0_PAYLOAD_SIZE];
+
+    if (length > (FLEXCAN0_PAYLOAD_SIZE - 1U)) {
+        length = FLEXCAN0_PAYLOAD_SIZE - 1U;
+    }
+    staged[0] = s_tx_seq++;
+    memcpy(&staged[1], buffer, length);
+    buffer = staged;
+    length++;
+#endif
+
+    uint8_t dlc = FLEXCAN0_len_to_dlc(length);
+    uint32_t cs = 0x0C400000 | ((uint32_t)dlc << CAN_WMBn_CS_DLC_SHIFT);
+
+#if FLEXCAN0_FD_ENABLE
+    cs |= MB_CS_EDL_MASK | MB_CS_BRS_MASK;
+#endif
 
     CAN0->IFLAG1 = (1UL << TX_MAILBOX);
+    FLEXCAN0_write_payload(TX_MAILBOX, buffer, length, s_dlc_to_len[dlc]);
     CAN0->RAMn[TX_MAILBOX * MSG_BUF_SIZE + 1] = (TX_MSG_ID << 18);
 
-    CAN0->RAMn[TX_MAILBOX * MSG_BUF_SIZE + 0] = 0x0C400000 |
-    		(DLC << CAN_WMBn_CS_DLC_SHIFT);
+    /* Writing CODE=0xC last hands the mailbox to the controller */
+    CAN0->RAMn[TX_MAILBOX * MSG_BUF_SIZE + 0] = cs;
+}
 
-    uint32_t dataWord = 0;
-    dataWord |= buffer[0];
-    dataWord |= ((uint32_t)buffer[1] << 8);
-    dataWord |= ((uint32_t)buffer[2] << 16);
-    dataWord |= ((uint32_t)buffer[3] << 24);
+/**
+ * Hardware timestamp of the last frame sent from the TX mailbox.
+ *
+ * @param timestamp Extended time (FLEXCAN0_TIMER_HZ ticks) the frame was sent.
+ * @return true once the frame has left the controller, false while pending.
+ */
+bool FLEXCAN0_get_tx_time(uint32_t *timestamp) {
 
-    CAN0->RAMn[TX_MAILBOX * MSG_BUF_SIZE+2] = dataWord;
+    uint32_t cs = CAN0->RAMn[TX_MAILBOX * MSG_BUF_SIZE + 0];
+
+    if (((cs & MB_CODE_MASK) >> MB_CODE_SHIFT) == MB_CODE_TX_DATA) {
+        return false;
+    }
+    *timestamp = FLEXCAN0_time_extend((uint16_t)(cs & MB_TIMESTAMP_MASK), FLEXCAN0_get_time());
+    return true;
 }
 
+/*
+ * Copy mailbox mb (or the RX FIFO output, which sits at MB0) into a frame.
+ * Reading the CS word locks a mailbox; the caller releases it.
+ *
+ * @return uint32_t The CS word.
+ */
+static uint32_t FLEXCAN0_copy_mailbox(uint32_t mb, flexcan_frame_t *frame) {
+
+    uint32_t cs = CAN0->RAMn[mb * MSG_BUF_SIZE + 0];
+
+    frame->dlc = (uint8_t)((cs & CAN_WMBn_CS_DLC_MASK) >> CAN_WMBn_CS_DLC_SHIFT);
+    frame->len = s_dlc_to_len[frame->dlc];
+    if (frame->len > FLEXCAN0_PAYLOAD_SIZE) {
+        frame->len = FLEXCAN0_PAYLOAD_SIZE;
+    }
+    frame->timestamp = cs & MB_TIMESTAMP_MASK; // extended by the caller once unlocked
+    frame->id = (CAN0->RAMn[mb * MSG_BUF_SIZE + 1] >> 18) & 0x7FFUL;
+
+    memset(frame->data, 0, sizeof(frame->data));
+    FLEXCAN0_read_payload(mb, frame->data, frame->len);
+    return cs;
+}
+
+#if FLEXCAN0_SEQ_HEADER_ENABLE
+/*
+ * Count the sequence number in byte 0 of a received frame and strip it.
+ * The 8-bit distance d from the expected number separates a gap
+ * (0 < d < 128: d frames lost) from a repeated or late frame (d >= 128).
+ * Called after the mailbox has been released.
+ */
+static void FLEXCAN0_seq_check(flexcan_frame_t *frame) {
+
+    uint8_t seq;
+    uint8_t diff;
+
+    if (frame->len == 0U) {
+        return; // no header, not a sequenced frame
+    }
+    seq = frame->data[0];
+    frame->len--;
+    memmove(frame->data, &frame->data[1], frame->len);
+    frame->data[frame->len] = 0;
+
+    g_flexcan0_seq_stats.received++;
+    diff = (uint8_t)(seq - s_rx_seq);
+    if (!s_rx_seq_valid || (diff == 0U)) {
+        s_rx_seq_valid = true;
+    } else if (diff < 128U) {
+        g_flexcan0_seq_stats.lost += diff;
+    } else if (seq == (uint8_t)(s_rx_seq - 1U)) {
+        g_flexcan0_seq_stats.duplicated++;
+        return;
+    } else {
+        g_flexcan0_seq_stats.out_of_order++;
+        if (g_flexcan0_seq_stats.lost != 0U) {
+            g_flexcan0_seq_stats.lost--; // counted as lost when the gap was seen
+        }
+        return;
+    }
+    s_rx_seq = (uint8_t)(seq + 1U);
+}
+#else
+#define FLEXCAN0_seq_check(frame) ((void)(frame))
+#endif
+
+/*
+ * Copy the RX mailbox into a frame and release it.
+ * Reading TIMER unlocks the mailbox and gives the reference to extend the
+ * frame timestamp.
+ *
+ * @return uint32_t The mailbox CODE read from the CS word.
+ */
+static uint32_t FLEXCAN0_read_mailbox(flexcan_frame_t *frame) {
+
+    uint32_t cs = FLEXCAN0_copy_mailbox(RX_MAILBOX, frame);
+    uint32_t now = FLEXCAN0_get_time();
+
+    frame->timestamp = FLEXCAN0_time_extend((uint16_t)frame->timestamp, now);
+    CAN0->IFLAG1 = (1UL << RX_MAILBOX);
+    FLEXCAN0_seq_check(frame);
+    return (cs & MB_CODE_MASK) >> MB_CODE_SHIFT;
+}
+
+#if !FLEXCAN0_RX_FIFO_ENABLE
 /**
  * Receive a CAN message from FLEXCAN0 MailBox and store it in a buffer.
  *
- * @param buffer_rx Pointer to a buffer to store received data
+ * @param buffer_rx Pointer to a buffer of FLEXCAN0_PAYLOAD_SIZE bytes
+ * @param timestamp Reception time in FLEXCAN0_TIMER_HZ ticks (may be NULL)
  * @return uint32_t Number of bytes received (0 if no valid message).
  */
-uint32_t FLEXCAN0_receive_msg(uint8_t *buffer_rx) {
+uint32_t FLEXCAN0_receive_msg(uint8_t *buffer_rx, uint32_t *timestamp) {
 
-    uint32_t RxCODE = (CAN0->RAMn[RX_MAILBOX * MSG_BUF_SIZE + 0] & 0x07000000) >> 24;
+    uint32_t RxCODE = (CAN0->RAMn[RX_MAILBOX * MSG_BUF_SIZE + 0] & MB_CODE_MASK) >> MB_CODE_SHIFT;
 
-    if (RxCODE != 0x2) {
+    if ((RxCODE != MB_CODE_RX_FULL) && (RxCODE != MB_CODE_RX_OVRN)) {
         return 0;
     }
-    uint32_t RxLENGTH = (CAN0->RAMn[RX_MAILBOX * MSG_BUF_SIZE + 0] &
-    		CAN_WMBn_CS_DLC_MASK) >> CAN_WMBn_CS_DLC_SHIFT;
-    uint32_t RxDATA = CAN0->RAMn[RX_MAILBOX * MSG_BUF_SIZE + 2];
+    flexcan_frame_t frame;
+    (void)FLEXCAN0_read_mailbox(&frame);
 
-    for (uint32_t i = 0; i < RxLENGTH && i < DLC; i++) {
-            buffer_rx[i] = (RxDATA >> (i * 8)) & 0xFF;
-        }
-    for (uint32_t i = RxLENGTH; i < DLC; i++) {
-        buffer_rx[i] = 0;
+    memcpy(buffer_rx, frame.data, frame.len);
+    if (timestamp != NULL) {
+        *timestamp = frame.timestamp;
+    }
+    return frame.len;
+}
+#endif
+
+/*
+ * Next free ring slot, or a scratch slot (counted as a software overrun)
+ * when the ring is full so the hardware can still be released.
+ */
+static flexcan_frame_t *FLEXCAN0_ring_reserve(void) {
+
+    uint32_t next = (s_rx_head + 1) & (FLEXCAN0_RX_RING_SIZE - 1);
+
+    if (next == s_rx_tail) {
+        s_rx_overrun.sw++;
+        return &s_rx_dropped;
+    }
+    return &s_rx_ring[s_rx_head];
+}
+
+/*
+ * Publish a slot returned by FLEXCAN0_ring_reserve() to the consumer.
+ */
+static void FLEXCAN0_ring_commit(const flexcan_frame_t *slot) {
+
+    if (slot != &s_rx_dropped) {
+        RING_BARRIER();
+        s_rx_head = (s_rx_head + 1) & (FLEXCAN0_RX_RING_SIZE - 1);
+    }
+}
+
+#if FLEXCAN0_RX_FIFO_ENABLE
+/*
+ * RX FIFO interrupt: drain every frame the FIFO holds in one entry.
+ * Clearing BUF5I pops the FIFO and exposes the next frame at MB0.
+ */
+static void FLEXCAN0_rx_isr(void) {
+
+    if ((CAN0->IFLAG1 & FIFO_FLAG_OVERFLOW) != 0) {
+        s_rx_overrun.hw++;
+        CAN0->IFLAG1 = FIFO_FLAG_OVERFLOW;
     }
 
-    (void)CAN0->TIMER;
+    while ((CAN0->IFLAG1 & FIFO_FLAG_AVAILABLE) != 0) {
+        flexcan_frame_t *slot = FLEXCAN0_ring_reserve();
+        (void)FLEXCAN0_copy_mailbox(0, slot);
+        slot->timestamp = FLEXCAN0_time_extend((uint16_t)slot->timestamp, FLEXCAN0_get_time());
+        CAN0->IFLAG1 = FIFO_FLAG_AVAILABLE;
+        FLEXCAN0_seq_check(slot);
+        FLEXCAN0_ring_commit(slot);
+    }
+    CAN0->IFLAG1 = FIFO_FLAG_WARNING;
+}
+#else
+/*
+ * RX mailbox interrupt: move the frame into the ring and release the mailbox
+ * as fast as possible so the next frame can be accepted.
+ */
+static void FLEXCAN0_rx_isr(void) {
+
+    if ((CAN0->IFLAG1 & (1UL << RX_MAILBOX)) == 0) {
+        return;
+    }
+
+    flexcan_frame_t *slot = FLEXCAN0_ring_reserve();
+    if (FLEXCAN0_read_mailbox(slot) == MB_CODE_RX_OVRN) {
+        s_rx_overrun.hw++;
+    }
+    FLEXCAN0_ring_commit(slot);
+}
+#endif
+
+/**
+ * Switch the receive path to interrupt mode. Frames are then only
+ * available through FLEXCAN0_read_frame().
+ */
+void FLEXCAN0_enable_rx_irq(void) {
+
+    s_rx_head = 0;
+    s_rx_tail = 0;
+    s_rx_overrun.hw = 0;
+    s_rx_overrun.sw = 0;
+
+    INT_SYS_InstallHandler(CAN0_ORed_0_15_MB_IRQn, &FLEXCAN0_rx_isr, NULL);
+#if FLEXCAN0_RX_FIFO_ENABLE
+    CAN0->IFLAG1 = FIFO_FLAG_OVERFLOW | FIFO_FLAG_WARNING;
+    CAN0->IMASK1 |= FIFO_FLAG_AVAILABLE | FIFO_FLAG_OVERFLOW;
+#else
     CAN0->IFLAG1 = (1UL << RX_MAILBOX);
-    return RxLENGTH;
+    CAN0->IMASK1 |= (1UL << RX_MAILBOX);
+#endif
+    INT_SYS_EnableIRQ(CAN0_ORed_0_15_MB_IRQn);
+}
+
+/**
+ * @return true if at least one frame is waiting in the receive ring.
+ */
+bool FLEXCAN0_rx_pending(void) {
+    return s_rx_head != s_rx_tail;
+}
+
+/**
+ * Take the oldest frame out of the receive ring.
+ *
+ * @param frame Destination for the frame.
+ * @return true if a frame was copied, false if the ring is empty.
+ */
+bool FLEXCAN0_read_frame(flexcan_frame_t *frame) {
+
+    uint32_t tail = s_rx_tail;
+
+    if (tail == s_rx_head) {
+        return false;
+    }
+    RING_BARRIER();
+    *frame = s_rx_ring[tail];
+    RING_BARRIER();
+    s_rx_tail = (tail + 1) & (FLEXCAN0_RX_RING_SIZE - 1);
+    return true;
+}
+
+/**
+ * Snapshot of the receive overrun counters.
+ */
+void FLEXCAN0_get_rx_overrun(flexcan_rx_overrun_t *overrun) {
+    overrun->hw = s_rx_overrun.hw;
+    overrun->sw = s_rx_overrun.sw;
+}
+
+/**
+ * Snapshot of the sequence header counters (all 0 unless
+ * FLEXCAN0_SEQ_HEADER_ENABLE is set).
+ */
+void FLEXCAN0_get_seq_stats(flexcan_seq_stats_t *stats) {
+    stats->received = g_flexcan0_seq_stats.received;
+    stats->lost = g_flexcan0_seq_stats.lost;
+    stats->duplicated = g_flexcan0_seq_stats.duplicated;
+    stats->out_of_order = g_flexcan0_seq_stats.out_of_order;
 }
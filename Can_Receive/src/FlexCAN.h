@@ -2,16 +2,143 @@
 #define FLEXCAN_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
-#define MSG_BUF_SIZE  4
+/* Bit timing, solved at compile time by can_timing.h.
+ * FLEXCAN0_CLK_SRC: 0 = oscillator (SOSCDIV2), 1 = bus clock. */
+#define FLEXCAN0_CLK_SRC          (0UL)
+#define FLEXCAN0_CLK_HZ           (8000000UL)
+#define FLEXCAN0_BITRATE          (500000UL)
+#define FLEXCAN0_SAMPLE_POINT     (75UL)      // percent
+#define FLEXCAN0_CLK_TOL_PPM      (1000UL)    // oscillator tolerance the timing must absorb
+#define FLEXCAN0_FD_BITRATE       (1000000UL) // data phase, FD only
+#define FLEXCAN0_FD_SAMPLE_POINT  (75UL)
+
+/* Payload configuration. Classic CAN carries up to 8 bytes; with
+ * FLEXCAN0_FD_ENABLE = 1 each mailbox holds FLEXCAN0_PAYLOAD_SIZE bytes
+ * (8, 16, 32 or 64) and frames are sent with bit rate switching. */
+#define FLEXCAN0_FD_ENABLE     (0)
+#define FLEXCAN0_PAYLOAD_SIZE  (8UL)
+
+#if (FLEXCAN0_PAYLOAD_SIZE != 8UL) && (FLEXCAN0_PAYLOAD_SIZE != 16UL) && \
+    (FLEXCAN0_PAYLOAD_SIZE != 32UL) && (FLEXCAN0_PAYLOAD_SIZE != 64UL)
+#error "FLEXCAN0_PAYLOAD_SIZE must be 8, 16, 32 or 64"
+#endif
+#if (FLEXCAN0_FD_ENABLE == 0) && (FLEXCAN0_PAYLOAD_SIZE != 8UL)
+#error "Payloads above 8 bytes need FLEXCAN0_FD_ENABLE"
+#endif
+
+/* RX FIFO mode: 1 = receive through the 6-deep FlexCAN RX FIFO filtered by
+ * FLEXCAN0_RX_FIFO_IDS (up to 8 standard IDs) instead of the single RX
+ * mailbox. The FIFO and its filter table occupy MB0..MB7. */
+#define FLEXCAN0_RX_FIFO_ENABLE  (0)
+#define FLEXCAN0_RX_FIFO_IDS     { RX_MSG_ID }
+
+#if FLEXCAN0_RX_FIFO_ENABLE && FLEXCAN0_FD_ENABLE
+#error "The RX FIFO cannot be used together with CAN FD"
+#endif
+
+/* Sequence header: 1 = byte 0 of every frame carries a rolling 8-bit
+ * counter. The transmit path stamps it (the application payload shrinks by
+ * one byte), the receive path checks and strips it and counts gaps in
+ * g_flexcan0_seq_stats. Both nodes must use the same setting. */
+#define FLEXCAN0_SEQ_HEADER_ENABLE  (0)
+
+#define MSG_BUF_SIZE       (2UL + (FLEXCAN0_PAYLOAD_SIZE / 4UL)) // Words per MB: CS + ID + payload
+#define FLEXCAN0_MB_COUNT  (128UL / MSG_BUF_SIZE)                // MBs that fit in CAN0 RAM
+#if FLEXCAN0_RX_FIFO_ENABLE
+#define TX_MAILBOX  (8UL) // MB8, first MB after the FIFO filter table
+#else
 #define TX_MAILBOX  (0UL) // MB0
-#define TX_MSG_ID   (1UL) // 0x01
+#endif
+#define TX_MSG_ID   (2UL) // 0x02 (echo back to the transmit node)
 #define RX_MAILBOX  (4UL) // MB4
-#define RX_MSG_ID   (2UL) // 0x02
-#define DLC 		(4UL) // 4 bytes
+#define RX_MSG_ID   (1UL) // 0x01 (ID sent by the transmit node)
+
+#define MB_CODE_MASK      (0x0F000000UL)
+#define MB_CODE_SHIFT     (24UL)
+#define MB_CODE_RX_FULL   (0x2UL)
+#define MB_CODE_RX_OVRN   (0x6UL) // MB overwritten before it was read
+#define MB_CODE_TX_DATA   (0xCUL) // TX frame pending or in flight
+#define MB_TIMESTAMP_MASK (0x0000FFFFUL)
+
+/* The 16-bit FlexCAN timer counts nominal bit times. Timestamps are extended
+ * to 32 bits in software: every RX/TX access and FLEXCAN0_get_time() track
+ * the wraps, so at least one of them must run once per 65536 bit times
+ * (131 ms at 500 kbps) to keep the upper half exact. */
+#define FLEXCAN0_TIMER_HZ  FLEXCAN0_BITRATE
+#define MB_CS_EDL_MASK    (0x80000000UL) // Extended data length (FD frame)
+#define MB_CS_BRS_MASK    (0x40000000UL) // Bit rate switch
+
+#define FIFO_FLAG_AVAILABLE (1UL << 5) // IFLAG1 BUF5I: frame available in RX FIFO
+#define FIFO_FLAG_WARNING   (1UL << 6) // IFLAG1 BUF6I: 4 frames in RX FIFO
+#define FIFO_FLAG_OVERFLOW  (1UL << 7) // IFLAG1 BUF7I: RX FIFO overflow
+#define FIFO_FILTER_COUNT   (8UL)      // Format A elements with RFFN = 0
+#define FIFO_FILTER_WORD    (24UL)     // Filter table starts at MB6
+
+#if (RX_MAILBOX >= FLEXCAN0_MB_COUNT) || (TX_MAILBOX >= FLEXCAN0_MB_COUNT)
+#error "Mailbox index beyond the MBs available for FLEXCAN0_PAYLOAD_SIZE"
+#endif
+
+#define FLEXCAN0_RX_RING_SIZE  (16UL) // Number of frames, must be a power of 2
+
+#if (FLEXCAN0_RX_RING_SIZE & (FLEXCAN0_RX_RING_SIZE - 1UL)) != 0UL
+#error "FLEXCAN0_RX_RING_SIZE must be a power of 2"
+#endif
+
+/**
+ * One received CAN frame as stored in the receive ring.
+ */
+typedef struct {
+    uint32_t id;                            /* Standard ID (11 bit) */
+    uint8_t  data[FLEXCAN0_PAYLOAD_SIZE];   /* Payload (word aligned), unused bytes are 0 */
+    uint8_t  dlc;                           /* Data length code */
+    uint8_t  len;                           /* Payload length in bytes decoded from dlc */
+    uint32_t timestamp;                     /* Extended FlexCAN timer at reception (FLEXCAN0_TIMER_HZ) */
+} flexcan_frame_t;
+
+/**
+ * Receive overrun counters.
+ * hw: the RX mailbox was overwritten before the ISR read it (CODE=OVERRUN),
+ *     or the RX FIFO overflowed.
+ * sw: a frame was dropped because the ring was full.
+ */
+typedef struct {
+    uint32_t hw;
+    uint32_t sw;
+} flexcan_rx_overrun_t;
+
+/**
+ * Sequence header counters (FLEXCAN0_SEQ_HEADER_ENABLE), updated on reception.
+ * received:     frames carrying a header.
+ * lost:         sequence numbers skipped; a frame that arrives late is
+ *               taken back out of lost and counted as out_of_order instead.
+ * duplicated:   frame with the same number as the previous one.
+ * out_of_order: frame older than the previous one.
+ */
+typedef struct {
+    uint32_t received;
+    uint32_t lost;
+    uint32_t duplicated;
+    uint32_t out_of_order;
+} flexcan_seq_stats_t;
+
+/* Live counters, readable from the debugger */
+extern volatile flexcan_seq_stats_t g_flexcan0_seq_stats;
 
 void FLEXCAN0_init(void);
-void FLEXCAN0_transmit_msg(uint8_t *buffer);
-uint32_t FLEXCAN0_receive_msg(uint8_t *buffer);
+void FLEXCAN0_transmit_msg(const uint8_t *buffer, uint8_t length);
+#if !FLEXCAN0_RX_FIFO_ENABLE
+uint32_t FLEXCAN0_receive_msg(uint8_t *buffer, uint32_t *timestamp);
+#endif
+
+void FLEXCAN0_enable_rx_irq(void);
+bool FLEXCAN0_rx_pending(void);
+bool FLEXCAN0_read_frame(flexcan_frame_t *frame);
+void FLEXCAN0_get_rx_overrun(flexcan_rx_overrun_t *overrun);
+void FLEXCAN0_get_seq_stats(flexcan_seq_stats_t *stats);
+
+uint32_t FLEXCAN0_get_time(void);
+bool FLEXCAN0_get_tx_time(uint32_t *timestamp);
 
 #endif /* FLEXCAN_H_ */
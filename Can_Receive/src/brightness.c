@@ -0,0 +1,77 @@
+#include "brightness.h"
+
+/* Repeat f(i) for 256 consecutive levels */
+#define BR_REP4(f, i)    f(i), f((i) + 1U), f((i) + 2U), f((i) + 3U)
+#define BR_REP16(f, i)   BR_REP4(f, i), BR_REP4(f, (i) + 4U), BR_REP4(f, (i) + 8U), BR_REP4(f, (i) + 12U)
+#define BR_REP64(f, i)   BR_REP16(f, i), BR_REP16(f, (i) + 16U), BR_REP16(f, (i) + 32U), BR_REP16(f, (i) + 48U)
+#define BR_REP256(f)     BR_REP64(f, 0U), BR_REP64(f, 64U), BR_REP64(f, 128U), BR_REP64(f, 192U)
+
+#define BR_MOD           ((uint64_t)BRIGHTNESS_MOD)
+
+/* Rounded n / d, integer constant expression */
+#define BR_DIV(n, d)     ((uint16_t)(((n) + ((d) / 2U)) / (d)))
+
+#define BR_LINEAR(x)     BR_DIV((uint64_t)(x) * BR_MOD, 255U)
+#define BR_GAMMA2(x)     BR_DIV((uint64_t)(x) * (x) * BR_MOD, 255U * 255U)
+#define BR_GAMMA3(x)     BR_DIV((uint64_t)(x) * (x) * (x) * BR_MOD, 255ULL * 255U * 255U)
+
+/*
+ * CIE 1931, with L* = 100 * x / 255:
+ *   Y = L* / 903.3              for L* <= 8
+ *   Y = ((L* + 16) / 116)^3     otherwise
+ * Both scaled by 255 (and 10) to stay in integers.
+ */
+#define BR_CIE_T(x)      ((uint64_t)(x) * 100U + 16U * 255U)
+#define BR_CIE(x)        (((uint32_t)(x) * 100U <= 8U * 255U) ? \
+                          BR_DIV((uint64_t)(x) * 1000U * BR_MOD, 255U * 9033U) : \
+                          BR_DIV(BR_CIE_T(x) * BR_CIE_T(x) * BR_CIE_T(x) * BR_MOD, \
+                                 29580ULL * 29580U * 29580U))
+
+static const uint16_t s_linear[BRIGHTNESS_STEPS]  = { BR_REP256(BR_LINEAR) };
+static const uint16_t s_gamma2[BRIGHTNESS_STEPS]  = { BR_REP256(BR_GAMMA2) };
+static const uint16_t s_gamma3[BRIGHTNESS_STEPS]  = { BR_REP256(BR_GAMMA3) };
+static const uint16_t s_cie1931[BRIGHTNESS_STEPS] = { BR_REP256(BR_CIE) };
+
+const uint16_t * const g_brightness_tables[BRIGHTNESS_CURVE_COUNT] = {
+    s_linear, s_gamma2, s_gamma3, s_cie1931
+};
+
+/* Curve per channel, all start on CIE 1931 (BRIGHTNESS_LINEAR is 0) */
+static uint8_t s_curve[PWM_INSTANCE_COUNT][PWM_CHANNEL_COUNT] = {
+    { BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931,
+      BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931 },
+    { BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931,
+      BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931 },
+    { BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931,
+      BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931 },
+    { BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931,
+      BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931, BRIGHTNESS_CIE1931 }
+};
+
+status_t BRIGHTNESS_SetCurve(uint8_t instanceIdx, uint8_t channel, brightness_curve_t curve)
+{
+    if ((instanceIdx >= PWM_INSTANCE_COUNT) || (channel >= PWM_CHANNEL_COUNT) ||
+        ((uint32_t)curve >= (uint32_t)BRIGHTNESS_CURVE_COUNT)) {
+        return STATUS_ERROR;
+    }
+    s_curve[instanceIdx][channel] = (uint8_t)curve;
+    return STATUS_SUCCESS;
+}
+
+brightness_curve_t BRIGHTNESS_GetCurve(uint8_t instanceIdx, uint8_t channel)
+{
+    if ((instanceIdx >= PWM_INSTANCE_COUNT) || (channel >= PWM_CHANNEL_COUNT)) {
+        return BRIGHTNESS_LINEAR;
+    }
+    return (brightness_curve_t)s_curve[instanceIdx][channel];
+}
+
+status_t BRIGHTNESS_Set(uint8_t instanceIdx, uint8_t channel, uint8_t level, uint16_t periods)
+{
+    if ((instanceIdx >= PWM_INSTANCE_COUNT) || (channel >= PWM_CHANNEL_COUNT)) {
+        return STATUS_ERROR;
+    }
+    return PWM_RampDuty_rs(instanceIdx, channel,
+                           BRIGHTNESS_Duty((brightness_curve_t)s_curve[instanceIdx][channel], level),
+                           periods);
+}
@@ -0,0 +1,61 @@
+#ifndef BRIGHTNESS_H_
+#define BRIGHTNESS_H_
+
+#include <stdint.h>
+#include "status.h"
+#include "pwm.h"
+
+/*
+ * Perceptual brightness curves for LED channels.
+ *
+ * Each curve maps a 0-255 level to a duty in ticks for BRIGHTNESS_MOD. The
+ * tables are constant initializers expanded by the preprocessor and folded
+ * by the compiler, so they live in flash and a lookup is a single load;
+ * nothing is computed at run time.
+ */
+
+#define BRIGHTNESS_MOD   (4999U)  // MOD the tables are in; command.c rescales them after SET_PERIOD
+#define BRIGHTNESS_STEPS (256U)
+
+typedef enum {
+    BRIGHTNESS_LINEAR = 0,  /* duty proportional to level */
+    BRIGHTNESS_GAMMA2,      /* level^2 */
+    BRIGHTNESS_GAMMA3,      /* level^3 */
+    BRIGHTNESS_CIE1931,     /* level is CIE L* (lightness), duty is luminance */
+    BRIGHTNESS_CURVE_COUNT
+} brightness_curve_t;
+
+extern const uint16_t * const g_brightness_tables[BRIGHTNESS_CURVE_COUNT];
+
+/**
+ * Duty in ticks for an 8-bit level on a curve.
+ */
+static inline uint16_t BRIGHTNESS_Duty(brightness_curve_t curve, uint8_t level)
+{
+    return g_brightness_tables[curve][level];
+}
+
+/**
+ * Duty in ticks for a 16-bit level: linear between two table entries,
+ * one multiply and a shift.
+ */
+static inline uint16_t BRIGHTNESS_Duty16(brightness_curve_t curve, uint16_t level)
+{
+    const uint16_t *table = g_brightness_tables[curve];
+    uint32_t index = (uint32_t)level >> 8;
+    uint32_t a = table[index];
+    uint32_t b = (index < (BRIGHTNESS_STEPS - 1U)) ? table[index + 1U] : BRIGHTNESS_MOD;
+
+    return (uint16_t)(a + ((((b - a) * (level & 0xFFU)) + 0x80U) >> 8));
+}
+
+status_t BRIGHTNESS_SetCurve(uint8_t instanceIdx, uint8_t channel, brightness_curve_t curve);
+brightness_curve_t BRIGHTNESS_GetCurve(uint8_t instanceIdx, uint8_t channel);
+
+/**
+ * Look the level up on the channel's curve and ramp to it (periods = 0: at
+ * the next period boundary).
+ */
+status_t BRIGHTNESS_Set(uint8_t instanceIdx, uint8_t channel, uint8_t level, uint16_t periods);
+
+#endif /* BRIGHTNESS_H_ */
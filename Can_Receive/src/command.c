@@ -0,0 +1,263 @@
+#include <stddef.h>
+#include <stdbool.h>
+#include "command.h"
+#include "pwm.h"
+#include "pwm_wave.h"
+#include "brightness.h"
+
+/* SET_MODE: duty changes slew over this many PWM periods */
+#define CMD_MODE_RAMP_PERIODS  (80U)
+
+/* SET_MODE 4: triangle "breathing" played by eDMA, up then down */
+#define CMD_MODE_BREATHE       (4U)
+#define BREATHE_HALF_STEPS     (400U)  // PWM periods per half cycle
+
+typedef void (*cmd_handler_t)(const uint8_t *args);
+
+typedef struct {
+    uint8_t len;            // Argument bytes after the opcode
+    cmd_handler_t handler;  // NULL: opcode not accepted
+} cmd_entry_t;
+
+static uint8_t s_instance = 0;
+static uint8_t s_channels = 0;
+static uint8_t s_mode_channel = 0;
+static cmd_stats_t s_stats;
+
+/* CMD_OP_STATUS answer of the frame being decoded, sent instead of its echo */
+static uint8_t s_reply[CMD_REPLY_SIZE];
+static uint8_t s_reply_len = 0;
+
+/* Duty writes of the frame being decoded, flushed as one batch */
+static uint8_t s_pending_mask = 0;
+static uint16_t s_pending_duty[PWM_CHANNEL_COUNT];
+
+static uint16_t s_breathe_table[2U * BREATHE_HALF_STEPS];
+
+/* Brightness tables are in ticks of BRIGHTNESS_MOD; Q16 factor to the current MOD */
+static uint32_t s_level_scale = 1UL << 16;
+
+/* Perceived brightness of SET_MODE 0-3, mapped to duty by the channel's curve */
+static const uint8_t s_mode_level[CMD_MODE_BREATHE] = {
+    0U,    // off
+    102U,  // 40%
+    153U,  // 60%
+    204U   // 80%
+};
+
+static void CMD_BuildBreathe(void) {
+    uint16_t mod = PWM_GetMod(s_instance);
+    uint32_t i;
+
+    for (i = 0; i < BREATHE_HALF_STEPS; i++) {
+        s_breathe_table[i] = (uint16_t)((i * mod) / BREATHE_HALF_STEPS);
+        s_breathe_table[(2U * BREATHE_HALF_STEPS) - 1U - i] = s_breathe_table[i];
+    }
+}
+
+/* Once per period change, keeps the division out of the level lookups */
+static void CMD_SetLevelScale(void) {
+    uint32_t mod = PWM_GetMod(s_instance);
+
+    s_level_scale = ((mod + 1U) << 16) / (BRIGHTNESS_MOD + 1U);
+}
+
+/* Duty in ticks of the current MOD for a level on the channel's curve */
+static uint16_t CMD_LevelDuty(uint8_t channel, uint8_t level) {
+    uint32_t duty = BRIGHTNESS_Duty(BRIGHTNESS_GetCurve(s_instance, channel), level);
+
+    return (uint16_t)((duty * s_level_scale) >> 16);
+}
+
+/*
+ * The waveform player owns its channel; a command writing that channel
+ * takes it back first.
+ */
+static void CMD_Claim(uint8_t mask) {
+    if (((mask & (1U << s_mode_channel)) != 0U) && PWM_WAVE_IsPlaying()) {
+        PWM_WAVE_Stop();
+    }
+}
+
+static void CMD_SetPending(uint8_t mask, uint16_t duty) {
+    uint8_t channel;
+
+    CMD_Claim(mask);
+    for (channel = 0; channel < PWM_CHANNEL_COUNT; channel++) {
+        if ((mask & (1U << channel)) != 0U) {
+            s_pending_duty[channel] = duty;
+        }
+    }
+    s_pending_mask |= mask;
+}
+
+static void CMD_Flush(void) {
+    uint8_t channels[PWM_CHANNEL_COUNT];
+    uint16_t duty[PWM_CHANNEL_COUNT];
+    uint8_t count = 0;
+    uint8_t channel;
+
+    if (s_pending_mask == 0U) {
+        return;
+    }
+    for (channel = 0; channel < PWM_CHANNEL_COUNT; channel++) {
+        if ((s_pending_mask & (1U << channel)) != 0U) {
+            channels[count] = channel;
+            duty[count] = s_pending_duty[channel];
+            count++;
+        }
+    }
+    s_pending_mask = 0;
+    (void)PWM_UpdateDutyBatch_rs(s_instance, count, channels, duty);
+}
+
+static void CmdSetMode(const uint8_t *args) {
+    uint8_t mode = args[0];
+    uint8_t bit = (uint8_t)(1U << s_mode_channel);
+
+    if (mode == CMD_MODE_BREATHE) {
+        s_pending_mask &= (uint8_t)~bit;
+        if (!PWM_WAVE_IsPlaying()) {
+            (void)PWM_WAVE_Start(s_mode_channel, s_breathe_table, 2U * BREATHE_HALF_STEPS, true);
+        }
+        return;
+    }
+    CMD_Claim(bit);
+    s_pending_mask &= (uint8_t)~bit;
+    (void)PWM_RampDuty_rs(s_instance, s_mode_channel,
+                          CMD_LevelDuty(s_mode_channel, (mode < CMD_MODE_BREATHE) ? s_mode_level[mode] : 0U),
+                          CMD_MODE_RAMP_PERIODS);
+}
+
+static void CmdSetDuty(const uint8_t *args) {
+    CMD_SetPending(args[0] & s_channels, CMD_GET16(&args[1]));
+}
+
+static void CmdRampTo(const uint8_t *args) {
+    uint8_t mask = args[0] & s_channels;
+    uint16_t duty = CMD_GET16(&args[1]);
+    uint16_t periods = CMD_GET16(&args[3]);
+    uint8_t channel;
+
+    CMD_Claim(mask);
+    // A ramp replaces a duty set earlier in the same frame
+    s_pending_mask &= (uint8_t)~mask;
+    for (channel = 0; channel < PWM_CHANNEL_COUNT; channel++) {
+        if ((mask & (1U << channel)) != 0U) {
+            (void)PWM_RampDuty_rs(s_instance, channel, duty, periods);
+        }
+    }
+}
+
+static void CmdSetLevel(const uint8_t *args) {
+    uint8_t mask = args[0] & s_channels;
+    uint8_t channel;
+
+    CMD_Claim(mask);
+    // Channels may sit on different curves, so the duty is looked up per channel
+    for (channel = 0; channel < PWM_CHANNEL_COUNT; channel++) {
+        if ((mask & (1U << channel)) != 0U) {
+            s_pending_duty[channel] = CMD_LevelDuty(channel, args[1]);
+        }
+    }
+    s_pending_mask |= mask;
+}
+
+static void CmdSetCurve(const uint8_t *args) {
+    uint8_t mask = args[0] & s_channels;
+    uint8_t channel;
+
+    for (channel = 0; channel < PWM_CHANNEL_COUNT; channel++) {
+        if ((mask & (1U << channel)) != 0U) {
+            (void)BRIGHTNESS_SetCurve(s_instance, channel, (brightness_curve_t)args[1]);
+        }
+    }
+}
+
+static void CmdSetPeriod(const uint8_t *args) {
+    CMD_Claim(1U << s_mode_channel);
+    // Duties queued so far were meant for the old period, apply them first
+    CMD_Flush();
+    if (PWM_UpdatePeriod_rs(s_instance, CMD_GET16(args)) == STATUS_SUCCESS) {
+        CMD_SetLevelScale();
+        CMD_BuildBreathe();
+    }
+}
+
+static void CmdQueryStatus(const uint8_t *args) {
+    uint8_t ramping = 0;
+    uint8_t channel;
+
+    (void)args;
+    for (channel = 0; channel < PWM_CHANNEL_COUNT; channel++) {
+        if (((s_channels & (1U << channel)) != 0U) && PWM_RampBusy(s_instance, channel)) {
+            ramping |= (uint8_t)(1U << channel);
+        }
+    }
+    // A later query in the same frame overwrites this one
+    s_reply[0] = CMD_OP_STATUS;
+    (void)CMD_Put16(&s_reply[1], PWM_GetMod(s_instance));
+    s_reply[3] = ramping;
+    s_reply[4] = PWM_WAVE_IsPlaying() ? 1U : 0U;
+    (void)CMD_Put16(&s_reply[5], (uint16_t)s_stats.rejected);
+    s_reply_len = (uint8_t)sizeof(s_reply);
+}
+
+static const cmd_entry_t s_commands[CMD_OP_COUNT] = {
+    [CMD_OP_END]          = { CMD_LEN_END,          NULL           },
+    [CMD_OP_SET_MODE]     = { CMD_LEN_SET_MODE,     CmdSetMode     },
+    [CMD_OP_SET_DUTY]     = { CMD_LEN_SET_DUTY,     CmdSetDuty     },
+    [CMD_OP_RAMP_TO]      = { CMD_LEN_RAMP_TO,      CmdRampTo      },
+    [CMD_OP_SET_LEVEL]    = { CMD_LEN_SET_LEVEL,    CmdSetLevel    },
+    [CMD_OP_SET_CURVE]    = { CMD_LEN_SET_CURVE,    CmdSetCurve    },
+    [CMD_OP_SET_PERIOD]   = { CMD_LEN_SET_PERIOD,   CmdSetPeriod   },
+    [CMD_OP_QUERY_STATUS] = { CMD_LEN_QUERY_STATUS, CmdQueryStatus },
+};
+
+void CMD_Init(uint8_t instanceIdx, uint8_t channelMask, uint8_t modeChannel) {
+    s_instance = instanceIdx;
+    s_channels = channelMask;
+    s_mode_channel = modeChannel;
+    s_pending_mask = 0;
+    s_stats.frames = 0;
+    s_stats.commands = 0;
+    s_stats.rejected = 0;
+    CMD_SetLevelScale();
+    CMD_BuildBreathe();
+}
+
+uint32_t CMD_Execute(const uint8_t *data, uint32_t len) {
+    uint32_t pos = 0;
+    uint32_t count = 0;
+
+    s_stats.frames++;
+    s_reply_len = 0;
+    while ((pos < len) && (data[pos] != CMD_OP_END)) {
+        uint8_t op = data[pos];
+
+        if ((op >= CMD_OP_COUNT) || (s_commands[op].handler == NULL) ||
+            ((pos + 1U + s_commands[op].len) > len)) {
+            s_stats.rejected++;
+            break;
+        }
+        s_commands[op].handler(&data[pos + 1U]);
+        pos += 1U + s_commands[op].len;
+        count++;
+    }
+    CMD_Flush();
+    s_stats.commands += count;
+    return count;
+}
+
+uint8_t CMD_GetReply(uint8_t *buffer) {
+    uint8_t i;
+
+    for (i = 0; i < s_reply_len; i++) {
+        buffer[i] = s_reply[i];
+    }
+    return s_reply_len;
+}
+
+void CMD_GetStats(cmd_stats_t *stats) {
+    *stats = s_stats;
+}
@@ -0,0 +1,59 @@
+#ifndef COMMAND_H_
+#define COMMAND_H_
+
+#include <stdint.h>
+#include "cmd_protocol.h"
+
+/*
+ * Decoder for the command frames of cmd_protocol.h.
+ *
+ * Opcodes index a table of {argument length, handler}, so dispatch costs
+ * the same for every command. Duty writes of one frame (SET_DUTY,
+ * SET_LEVEL) are collected and applied with a single
+ * PWM_UpdateDutyBatch_rs, so all of them change at the same reload point.
+ * SET_MODE and RAMP_TO start their ramp or waveform as soon as they are
+ * decoded, and drop a duty queued earlier in the frame for their channels.
+ */
+
+/* Longest answer a frame can produce (CMD_OP_STATUS) */
+#define CMD_REPLY_SIZE  (1U + CMD_LEN_STATUS)
+
+typedef struct {
+    uint32_t frames;    /* Frames decoded */
+    uint32_t commands;  /* Commands executed */
+    uint32_t rejected;  /* Frames cut short by an unknown opcode or a truncated command */
+} cmd_stats_t;
+
+/**
+ * @brief Bind the decoder to an initialized PWM instance.
+ *
+ * @param instanceIdx: FTM instance the commands drive
+ * @param channelMask: Channels commands may change, other mask bits are ignored
+ * @param modeChannel: Channel driven by SET_MODE (breathing plays on FTM0 only)
+ */
+void CMD_Init(uint8_t instanceIdx, uint8_t channelMask, uint8_t modeChannel);
+
+/**
+ * @brief Execute the commands of one frame payload, in order.
+ *
+ * Decoding stops at CMD_OP_END, at the end of the payload, or at the first
+ * unknown or truncated command; commands before it still take effect.
+ *
+ * @return Number of commands executed
+ */
+uint32_t CMD_Execute(const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Answer produced by the last CMD_Execute (QUERY_STATUS), if any.
+ *
+ * The receiver has a single TX mailbox, so the answer is sent in place of
+ * the frame's echo; several queries in one frame give one answer.
+ *
+ * @param buffer: At least CMD_REPLY_SIZE bytes
+ * @return Answer length, 0 if the frame asked for none
+ */
+uint8_t CMD_GetReply(uint8_t *buffer);
+
+void CMD_GetStats(cmd_stats_t *stats);
+
+#endif /* COMMAND_H_ */
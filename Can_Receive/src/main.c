@@ -4,16 +4,27 @@
 #include <stdbool.h>
 #include <FlexCan.h>
 #include <pwm.h>
+#include <brightness.h>
+#include <command.h>
+#include <edma_driver.h>
 
-#define TX_MAILBOX  (1UL) // MB1
-#define TX_MSG_ID   (1UL) // 0x01
-#define RX_MAILBOX  (4UL) // MB4
-#define RX_MSG_ID   (2UL) // 0x02
+/* 1: only echo frames back for the Can_Transmit ping-pong benchmark */
+#define BENCHMARK_PINGPONG  0
 
+/* FTM0 CH1 drives the output */
+#define PWM_INSTANCE        (0U)
+#define PWM_CHANNEL         (1U)
+#define PWM_MOD             BRIGHTNESS_MOD  // MOD = period - 1
 
-uint8_t rx_buffer[4] = {0};
-uint32_t RxLENGTH = 0;
-uint32_t duty_cycle = 0;
+
+static edma_state_t edmaState;
+static const edma_user_config_t edmaUserConfig = {
+    .chnArbitration = EDMA_ARBITRATION_FIXED_PRIORITY,
+    .haltOnError = false
+};
+
+flexcan_frame_t rx_frame;
+uint8_t tx_reply[CMD_REPLY_SIZE];
 volatile int exit_code = 0;
 
 
@@ -21,37 +32,48 @@ void BoardInit(void)
 {
     CLOCK_DRV_Init(&clockMan1_InitConfig0);
     PINS_DRV_Init(NUM_OF_CONFIGURED_PINS0, g_pin_mux_InitConfigArr0);
+    /* Channels are set up by their users (PWM waveform player) */
+    EDMA_DRV_Init(&edmaState, &edmaUserConfig, NULL, NULL, 0U);
 }
 
 
-void Update_PWM(uint8_t mode) {
-    switch (mode) {
-        case 1: duty_cycle = 2000; break; // 40%
-        case 2: duty_cycle = 3000; break; // 60%
-        case 3: duty_cycle = 4000; break; // 80%
-        default: duty_cycle = 0; break;
-    }
-}
-
 int main(void)
 {
     /* Do the initializations required for this application */
     BoardInit();
     FLEXCAN0_init();
-    PWM_FTM0_Init_Register();
+    FLEXCAN0_enable_rx_irq();
+    PWM_Init_Register(PWM_INSTANCE, PWM_MOD, 1U << PWM_CHANNEL);
 
-    Update_PWM(0);
-    PWM_UpdateDuty_rs(0, 1, duty_cycle);
+    CMD_Init(PWM_INSTANCE, 1U << PWM_CHANNEL, PWM_CHANNEL);
 
     while(1)
     {
-        if (CAN0->IFLAG1 & (1 << RX_MAILBOX)) {
-            RxLENGTH = FLEXCAN0_receive_msg(rx_buffer);
-            if (RxLENGTH != 0){
-                FLEXCAN0_transmit_msg(rx_buffer);
-                Update_PWM(rx_buffer[0]);
-            	PWM_UpdateDuty_rs(0, 1, duty_cycle);
+        if (FLEXCAN0_read_frame(&rx_frame)) {
+            if (rx_frame.len != 0){
+#if BENCHMARK_PINGPONG
+                FLEXCAN0_transmit_msg(rx_frame.data, rx_frame.len);
+#else
+                uint8_t reply_len;
+
+                (void)CMD_Execute(rx_frame.data, rx_frame.len);
+                /* The TX mailbox holds one frame: a status answer replaces the echo */
+                reply_len = CMD_GetReply(tx_reply);
+                if (reply_len != 0U) {
+                    FLEXCAN0_transmit_msg(tx_reply, reply_len);
+                } else {
+                    FLEXCAN0_transmit_msg(rx_frame.data, rx_frame.len);
+                }
+#endif
+            }
+        } else {
+            /* Sleep until the next interrupt; checking with interrupts masked
+             * closes the window between the test and WFI */
+            DISABLE_INTERRUPTS();
+            if (!FLEXCAN0_rx_pending()) {
+                STANDBY();
             }
+            ENABLE_INTERRUPTS();
         }
     }
 
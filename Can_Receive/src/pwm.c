@@ -1,50 +1,341 @@
 #include "S32K144.h"  // Thu vien dinh nghia cac thanh ghi
+#include <interrupt_manager.h>
+#include <ftm_common.h>
+#include <ftm_pwm_driver.h>
+#include "pwm.h"
 
-#define FTM0_MOD_VALUE 4999        // MOD = period - 1
-#define INIT_DUTY_CYCLE 2500       // 50% duty
+#define PWM_FRAC_MASK ((1UL << PWM_FRAC_BITS) - 1UL)
 
-void PWM_FTM0_Init_Register(void)
+/* Phần lẻ của bước ramp: Q16.15 để duty (tới 0xFFFF) và chênh lệch
+ * ±0xFFFF nhân 2^15 vẫn nằm trong int32_t */
+#define PWM_RAMP_FRAC_BITS (15U)
+
+typedef struct {
+    int32_t acc;          // Duty hiện tại, Q16.15
+    int32_t step;         // Bước mỗi chu kỳ, Q16.15
+    uint16_t target;      // Duty đích
+    uint16_t remaining;   // Số chu kỳ còn lại
+} pwm_ramp_t;
+
+typedef struct {
+    uint16_t mod;                          // MOD đã cấu hình, 0 = chưa khởi tạo
+    uint8_t channels;                      // Bit n = channel n là PWM
+    volatile uint8_t ramp_mask;            // Bit n = channel n đang ramp
+    volatile uint8_t dither_mask;          // Bit n = channel n có phần lẻ
+    uint16_t duty[PWM_CHANNEL_COUNT];      // Giá trị CnV đã ghi gần nhất
+    pwm_ramp_t ramp[PWM_CHANNEL_COUNT];
+    uint8_t frac[PWM_CHANNEL_COUNT];       // Phần lẻ của duty, 1/256 tick
+    uint8_t frac_acc[PWM_CHANNEL_COUNT];   // Bộ tích luỹ sigma-delta
+} pwm_instance_t;
+
+static pwm_instance_t s_pwm[PWM_INSTANCE_COUNT];
+
+static const uint8_t s_pcc_index[PWM_INSTANCE_COUNT] = {
+    PCC_FTM0_INDEX, PCC_FTM1_INDEX, PCC_FTM2_INDEX, PCC_FTM3_INDEX
+};
+static const IRQn_Type s_reload_irq[PWM_INSTANCE_COUNT] = FTM_Reload_IRQS;
+
+status_t PWM_Init_Register(uint8_t instanceIdx, uint16_t mod, uint8_t channelMask)
 {
-    /* 1. Bật Clock cho FTM0 */
-    PCC->PCCn[PCC_FTM0_INDEX] |= PCC_PCCn_CGC_MASK;
+    /* Đồng bộ bằng software trigger, nạp buffer tại điểm CNT = MOD */
+    const ftm_pwm_sync_t sync = {
+        .softwareSync = true,
+        .hardwareSync0 = false,
+        .hardwareSync1 = false,
+        .hardwareSync2 = false,
+        .maxLoadingPoint = true,
+        .minLoadingPoint = false,
+        .inverterSync = FTM_SYSTEM_CLOCK,
+        .outRegSync = FTM_SYSTEM_CLOCK,
+        .maskRegSync = FTM_SYSTEM_CLOCK,
+        .initCounterSync = FTM_PWM_SYNC,
+        .autoClearTrigger = false,
+        .syncPoint = FTM_WAIT_LOADING_POINTS
+    };
+    FTM_Type *ftm;
+    pwm_instance_t *pwm;
+    uint8_t channel;
+
+    if ((instanceIdx >= PWM_INSTANCE_COUNT) || (mod == 0U)) {
+        return STATUS_ERROR;
+    }
+    ftm = g_ftmBase[instanceIdx];
+    pwm = &s_pwm[instanceIdx];
+
+    /* 1. Bật Clock cho FTM */
+    PCC->PCCn[s_pcc_index[instanceIdx]] |= PCC_PCCn_CGC_MASK;
     /* 2. Disable Write Protection & FTM */
-    FTM0->MODE |= FTM_MODE_WPDIS_MASK;   // Tắt chế độ bảo vệ ghi
-    FTM0->SC = 0;                        // Tắt bộ đếm trước khi cấu hình
-    /* 3. Chọn chế độ Edge-aligned PWM cho kênh 1 */
-    FTM0->CONTROLS[1].CnSC = FTM_CnSC_MSB_MASK | FTM_CnSC_ELSB_MASK;
-    /* 4. Đặt giá trị MOD = chu kỳ */
-    FTM0->MOD = FTM0_MOD_VALUE;
-    /* 5. Đặt giá trị CnV = duty ban đầu */
-    FTM0->CONTROLS[1].CnV = INIT_DUTY_CYCLE;
-    /* 6. Reset CNT và CNTIN */
-    FTM0->CNTIN = 0;
-    FTM0->CNT = 0;
-    /* 7. Chọn nguồn clock: system clock và Prescaler = 1 */
-    FTM0->SC = FTM_SC_CLKS(1) | FTM_SC_PS(0);
-}
-
-typedef enum {
-    PWM_STATUS_SUCCESS = 0U,
-    PWM_STATUS_ERROR = 1U
-} pwm_status_t;
-
-
-pwm_status_t PWM_UpdateDuty_rs(uint8_t instanceIdx, uint8_t channel, uint16_t duty) {
-	pwm_status_t status = PWM_STATUS_ERROR;
-
-    // Giả sử instanceIdx 0 tương ứng với FTM0
-    if (instanceIdx == 0) {
-        if (channel < 8) {  // FTM có 8 channel: 0-7
-            if (duty > FTM0->MOD) {
-                duty = FTM0->MOD;  // Giới hạn duty không vượt quá MOD (100%)
-            }
-            FTM0->CONTROLS[channel].CnV = duty;
-            status = PWM_STATUS_SUCCESS;
+    ftm->MODE |= FTM_MODE_WPDIS_MASK;   // Tắt chế độ bảo vệ ghi
+    ftm->SC = 0;                        // Tắt bộ đếm trước khi cấu hình
+    /* 3. Chọn chế độ Edge-aligned PWM, duty ban đầu 0 */
+    for (channel = 0; channel < PWM_CHANNEL_COUNT; channel++) {
+        if ((channelMask & (1U << channel)) != 0U) {
+            ftm->CONTROLS[channel].CnSC = FTM_CnSC_MSB_MASK | FTM_CnSC_ELSB_MASK;
+            ftm->CONTROLS[channel].CnV = 0;
+        }
+        pwm->duty[channel] = 0;
+    }
+    /* 4. Đặt giá trị MOD = chu kỳ, lưu lại để không phải đọc thanh ghi mỗi lần */
+    ftm->MOD = mod;
+    pwm->mod = mod;
+    pwm->channels = channelMask;
+    pwm->ramp_mask = 0;
+    pwm->dither_mask = 0;
+    /* 5. Reset CNT và CNTIN */
+    ftm->CNTIN = 0;
+    ftm->CNT = 0;
+    /* 6. Bật đồng bộ CnV cho cả 4 cặp channel, CnV chỉ nạp ở điểm reload */
+    ftm->COMBINE |= FTM_COMBINE_SYNCEN0_MASK | FTM_COMBINE_SYNCEN1_MASK |
+                    FTM_COMBINE_SYNCEN2_MASK | FTM_COMBINE_SYNCEN3_MASK;
+    (void)FTM_DRV_SetSync(instanceIdx, &sync);
+    /* 7. Ngắt reload dùng cho ramp, chỉ bật RIE khi có channel đang ramp */
+    INT_SYS_EnableIRQ(s_reload_irq[instanceIdx]);
+    /* 8. Chọn nguồn clock: system clock và Prescaler = 1 */
+    ftm->SC = FTM_SC_CLKS(1) | FTM_SC_PS(0);
+
+    return STATUS_SUCCESS;
+}
+
+uint16_t PWM_GetMod(uint8_t instanceIdx)
+{
+    return (instanceIdx < PWM_INSTANCE_COUNT) ? s_pwm[instanceIdx].mod : 0U;
+}
+
+/*
+ * true nếu instance đã khởi tạo và channel được cấu hình là PWM.
+ */
+static inline bool PWM_IsValid(uint8_t instanceIdx, uint8_t channel)
+{
+    return (instanceIdx < PWM_INSTANCE_COUNT) && (channel < PWM_CHANNEL_COUNT) &&
+           ((s_pwm[instanceIdx].channels & (1U << channel)) != 0U);
+}
+
+static inline uint16_t PWM_Clamp(const pwm_instance_t *pwm, uint16_t duty)
+{
+    return (duty > pwm->mod) ? pwm->mod : duty;  // Giới hạn duty không vượt quá MOD (100%)
+}
+
+/*
+ * Ghi CnV vào buffer; phải đặt SWSYNC để nạp ở điểm reload kế tiếp.
+ */
+static inline void PWM_WriteDuty(uint8_t instanceIdx, uint8_t channel, uint16_t duty)
+{
+    g_ftmBase[instanceIdx]->CONTROLS[channel].CnV = duty;
+    s_pwm[instanceIdx].duty[channel] = duty;
+}
+
+/*
+ * Bật ngắt reload; xoá cờ cũ để lần xử lý đầu rơi vào điểm reload kế tiếp.
+ */
+static inline void PWM_EnableReloadInt(uint8_t instanceIdx)
+{
+    g_ftmBase[instanceIdx]->SC &= ~FTM_SC_RF_MASK;
+    g_ftmBase[instanceIdx]->SC |= FTM_SC_RIE_MASK;
+}
+
+status_t PWM_UpdateDuty_rs(uint8_t instanceIdx, uint8_t channel, uint16_t duty) {
+    return PWM_UpdateDutyBatch_rs(instanceIdx, 1U, &channel, &duty);
+}
+
+status_t PWM_UpdateDutyBatch_rs(uint8_t instanceIdx, uint8_t count,
+                                const uint8_t channels[], const uint16_t duty[]) {
+    uint16_t clamped[PWM_CHANNEL_COUNT];
+    pwm_instance_t *pwm;
+    FTM_Type *ftm;
+    uint8_t mask = 0;
+    uint8_t i;
+
+    if ((count == 0U) || (count > PWM_CHANNEL_COUNT)) {
+        return STATUS_ERROR;
+    }
+    // Kiểm tra hết trước khi ghi, một channel sai thì không đổi gì
+    for (i = 0; i < count; i++) {
+        if (!PWM_IsValid(instanceIdx, channels[i])) {
+            return STATUS_ERROR;
+        }
+    }
+    pwm = &s_pwm[instanceIdx];
+    ftm = g_ftmBase[instanceIdx];
+    for (i = 0; i < count; i++) {
+        clamped[i] = PWM_Clamp(pwm, duty[i]);
+        mask |= (uint8_t)(1U << channels[i]);
+    }
+
+    INT_SYS_DisableIRQ(s_reload_irq[instanceIdx]);
+    pwm->ramp_mask &= (uint8_t)~mask;
+    pwm->dither_mask &= (uint8_t)~mask;
+    /* Trigger của bước ramp trước còn chờ thì sẽ nạp nửa batch ở điểm reload
+     * kế tiếp; đợi nó xong (tối đa một chu kỳ PWM) */
+    while ((ftm->SYNC & FTM_SYNC_SWSYNC_MASK) != 0U) {
+    }
+    (void)FTM_DRV_FastUpdatePwmChannels(instanceIdx, count, channels, clamped, true);
+    for (i = 0; i < count; i++) {
+        pwm->duty[channels[i]] = clamped[i];
+    }
+    INT_SYS_EnableIRQ(s_reload_irq[instanceIdx]);
+
+    return STATUS_SUCCESS;
+}
+
+status_t PWM_UpdatePeriod_rs(uint8_t instanceIdx, uint16_t mod) {
+    pwm_instance_t *pwm;
+    FTM_Type *ftm;
+    uint8_t channel;
+
+    if ((instanceIdx >= PWM_INSTANCE_COUNT) || (s_pwm[instanceIdx].mod == 0U) || (mod == 0U)) {
+        return STATUS_ERROR;
+    }
+    pwm = &s_pwm[instanceIdx];
+    ftm = g_ftmBase[instanceIdx];
+
+    INT_SYS_DisableIRQ(s_reload_irq[instanceIdx]);
+    // Bước ramp và phần lẻ tính theo MOD cũ, huỷ hết
+    pwm->ramp_mask = 0;
+    pwm->dither_mask = 0;
+    while ((ftm->SYNC & FTM_SYNC_SWSYNC_MASK) != 0U) {
+    }
+    /* MOD cũng đi qua buffer (SWWRBUF), nạp cùng CnV tại điểm reload */
+    ftm->MOD = mod;
+    pwm->mod = mod;
+    for (channel = 0; channel < PWM_CHANNEL_COUNT; channel++) {
+        if (((pwm->channels & (1U << channel)) != 0U) && (pwm->duty[channel] > mod)) {
+            PWM_WriteDuty(instanceIdx, channel, mod);
         }
     }
+    ftm->SYNC |= FTM_SYNC_SWSYNC_MASK;
+    INT_SYS_EnableIRQ(s_reload_irq[instanceIdx]);
+
+    return STATUS_SUCCESS;
+}
+
+status_t PWM_RampDuty_rs(uint8_t instanceIdx, uint8_t channel, uint16_t duty, uint16_t periods) {
+    pwm_instance_t *pwm;
+    pwm_ramp_t *ramp;
+
+    if (!PWM_IsValid(instanceIdx, channel)) {
+        return STATUS_ERROR;
+    }
+    if (periods == 0U) {
+        return PWM_UpdateDuty_rs(instanceIdx, channel, duty);
+    }
+    pwm = &s_pwm[instanceIdx];
+    duty = PWM_Clamp(pwm, duty);
+
+    INT_SYS_DisableIRQ(s_reload_irq[instanceIdx]);
+    ramp = &pwm->ramp[channel];
+    // Bắt đầu từ duty hiện tại, kể cả khi đang giữa một ramp khác
+    ramp->acc = (int32_t)((uint32_t)pwm->duty[channel] << PWM_RAMP_FRAC_BITS);
+    ramp->step = (((int32_t)duty - (int32_t)pwm->duty[channel]) * ((int32_t)1 << PWM_RAMP_FRAC_BITS)) / (int32_t)periods;
+    ramp->target = duty;
+    ramp->remaining = periods;
+    pwm->ramp_mask |= (uint8_t)(1U << channel);
+    pwm->dither_mask &= (uint8_t)~(1U << channel);
+    PWM_EnableReloadInt(instanceIdx);
+    INT_SYS_EnableIRQ(s_reload_irq[instanceIdx]);
+
+    return STATUS_SUCCESS;
+}
+
+status_t PWM_UpdateDutyFine_rs(uint8_t instanceIdx, uint8_t channel, uint32_t dutyFine) {
+    pwm_instance_t *pwm;
+    uint32_t maxFine;
+    uint8_t bit = (uint8_t)(1U << channel);
+
+    if (!PWM_IsValid(instanceIdx, channel)) {
+        return STATUS_ERROR;
+    }
+    pwm = &s_pwm[instanceIdx];
+    maxFine = (uint32_t)pwm->mod << PWM_FRAC_BITS;
+    if (dutyFine > maxFine) {
+        dutyFine = maxFine;
+    }
+    if ((dutyFine & PWM_FRAC_MASK) == 0U) {
+        return PWM_UpdateDuty_rs(instanceIdx, channel, (uint16_t)(dutyFine >> PWM_FRAC_BITS));
+    }
+
+    INT_SYS_DisableIRQ(s_reload_irq[instanceIdx]);
+    pwm->ramp_mask &= (uint8_t)~bit;
+    pwm->frac[channel] = (uint8_t)(dutyFine & PWM_FRAC_MASK);
+    pwm->frac_acc[channel] = 0;
+    // Phần nguyên; ngắt reload cộng thêm 1 tick ở những chu kỳ bộ tích luỹ tràn
+    pwm->duty[channel] = (uint16_t)(dutyFine >> PWM_FRAC_BITS);
+    pwm->dither_mask |= bit;
+    PWM_EnableReloadInt(instanceIdx);
+    INT_SYS_EnableIRQ(s_reload_irq[instanceIdx]);
 
-    return status;
+    return STATUS_SUCCESS;
 }
 
+bool PWM_RampBusy(uint8_t instanceIdx, uint8_t channel) {
+    return PWM_IsValid(instanceIdx, channel) &&
+           ((s_pwm[instanceIdx].ramp_mask & (1U << channel)) != 0U);
+}
+
+/*
+ * Ngắt reload: mỗi chu kỳ PWM tiến mỗi ramp một bước và dither các channel
+ * có phần lẻ. Giá trị ghi ở đây được nạp tại điểm reload kế tiếp; khi không
+ * còn ramp hay dither thì tắt RIE.
+ */
+static void PWM_ReloadHandler(uint8_t instanceIdx)
+{
+    pwm_instance_t *pwm = &s_pwm[instanceIdx];
+    FTM_Type *ftm = g_ftmBase[instanceIdx];
+    uint8_t mask = pwm->ramp_mask;
+    uint8_t channel;
 
+    ftm->SC &= ~FTM_SC_RF_MASK;  // Đọc SC rồi ghi 0 để xoá RF
 
+    for (channel = 0; mask != 0U; channel++, mask >>= 1) {
+        pwm_ramp_t *ramp = &pwm->ramp[channel];
+
+        if ((mask & 1U) == 0U) {
+            continue;
+        }
+        if (--ramp->remaining == 0U) {
+            PWM_WriteDuty(instanceIdx, channel, ramp->target);
+            pwm->ramp_mask &= (uint8_t)~(1U << channel);
+        } else {
+            ramp->acc += ramp->step;
+            PWM_WriteDuty(instanceIdx, channel, (uint16_t)(ramp->acc >> PWM_RAMP_FRAC_BITS));
+        }
+    }
+
+    /* Sigma-delta bậc 1: trung bình CnV trên 256 chu kỳ bằng duty + frac/256,
+     * sai số trung bình sau N chu kỳ không quá 1/N tick */
+    mask = pwm->dither_mask;
+    for (channel = 0; mask != 0U; channel++, mask >>= 1) {
+        uint32_t sum;
+
+        if ((mask & 1U) == 0U) {
+            continue;
+        }
+        sum = (uint32_t)pwm->frac_acc[channel] + pwm->frac[channel];
+        pwm->frac_acc[channel] = (uint8_t)sum;
+        ftm->CONTROLS[channel].CnV = pwm->duty[channel] + (sum >> PWM_FRAC_BITS);
+    }
+    ftm->SYNC |= FTM_SYNC_SWSYNC_MASK;
+
+    if ((pwm->ramp_mask | pwm->dither_mask) == 0U) {
+        ftm->SC &= ~FTM_SC_RIE_MASK;
+    }
+}
+
+void FTM0_Ovf_Reload_IRQHandler(void)
+{
+    PWM_ReloadHandler(0U);
+}
+
+void FTM1_Ovf_Reload_IRQHandler(void)
+{
+    PWM_ReloadHandler(1U);
+}
+
+void FTM2_Ovf_Reload_IRQHandler(void)
+{
+    PWM_ReloadHandler(2U);
+}
+
+void FTM3_Ovf_Reload_IRQHandler(void)
+{
+    PWM_ReloadHandler(3U);
+}
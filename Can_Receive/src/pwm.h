@@ -2,20 +2,42 @@
 #define PWM_H_
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "status.h"
 
-typedef enum {
-    PWM_STATUS_SUCCESS = 0U,
-    PWM_STATUS_ERROR = 1U
-} pwm_status_t;
+/*
+ * PWM edge-aligned trên FTM0..FTM3, tối đa 8 channel mỗi instance.
+ *
+ * Mọi instance chạy ở chế độ đồng bộ (enhanced PWM sync): CnV ghi vào buffer
+ * và chỉ được nạp tại điểm reload (CNT = MOD), nên duty không bao giờ đổi
+ * giữa chu kỳ. Ramp được ngắt reload của instance tiến từng bước mỗi chu kỳ.
+ */
 
+#define PWM_INSTANCE_COUNT  (4U)   // FTM0..FTM3
+#define PWM_CHANNEL_COUNT   (8U)   // FTM có 8 channel: 0-7
+#define PWM_FRAC_BITS       (8U)   // Số bit phần lẻ của duty trong PWM_UpdateDutyFine_rs
 
 /**
- * @brief Khởi tạo FTM0 Channel 1 ở chế độ Edge-Aligned PWM.
+ * @brief Khởi tạo một FTM instance ở chế độ Edge-Aligned PWM, duty ban đầu 0.
+ *
+ * Pin mux của các channel do cấu hình PINS của board đảm nhận.
+ *
+ * @param instanceIdx: Số hiệu FTM instance (0..3)
+ * @param mod: Giá trị MOD = period - 1 (tính bằng tick)
+ * @param channelMask: Bit n = bật PWM cho channel n
+ * @return status_t: STATUS_SUCCESS nếu thành công, STATUS_ERROR nếu sai
  */
-void PWM_FTM0_Init_Register(void);
+status_t PWM_Init_Register(uint8_t instanceIdx, uint16_t mod, uint8_t channelMask);
 
 /**
- * @brief Cập nhật duty cycle cho FTM0 Channel.
+ * @brief Giá trị MOD đã cấu hình (duty 100%), 0 nếu instance chưa khởi tạo.
+ */
+uint16_t PWM_GetMod(uint8_t instanceIdx);
+
+/**
+ * @brief Cập nhật duty cycle cho một channel, có hiệu lực ở đầu chu kỳ kế tiếp.
+ *
+ * Huỷ ramp đang chạy trên channel (nếu có).
  *
  * @param instanceIdx: Số hiệu FTM instance (ví dụ: 0 cho FTM0)
  * @param channel: Số channel (ví dụ: 1 cho FTM0_CH1)
@@ -24,4 +46,56 @@ void PWM_FTM0_Init_Register(void);
  */
 status_t PWM_UpdateDuty_rs(uint8_t instanceIdx, uint8_t channel, uint16_t duty);
 
+/**
+ * @brief Cập nhật duty của nhiều channel cùng lúc, tất cả đổi tại cùng một điểm reload.
+ *
+ * Dùng FTM_DRV_FastUpdatePwmChannels và một software trigger duy nhất.
+ *
+ * @param count: Số channel (tối đa PWM_CHANNEL_COUNT)
+ * @param channels: Danh sách channel
+ * @param duty: Duty tương ứng, tính bằng số tick (tối đa là MOD)
+ * @return status_t: STATUS_ERROR nếu có channel sai, khi đó không channel nào bị đổi
+ */
+status_t PWM_UpdateDutyBatch_rs(uint8_t instanceIdx, uint8_t count,
+                                const uint8_t channels[], const uint16_t duty[]);
+
+/**
+ * @brief Đổi chu kỳ PWM (MOD), có hiệu lực ở điểm reload kế tiếp.
+ *
+ * Ramp và phần lẻ đang chạy trên instance bị huỷ; duty lớn hơn MOD mới được
+ * giới hạn về MOD.
+ *
+ * @param mod: Giá trị MOD mới = period - 1 (tính bằng tick)
+ * @return status_t: STATUS_SUCCESS nếu thành công, STATUS_ERROR nếu sai
+ */
+status_t PWM_UpdatePeriod_rs(uint8_t instanceIdx, uint16_t mod);
+
+/**
+ * @brief Cập nhật duty với độ phân giải dưới 1 tick bằng dithering.
+ *
+ * S32K144 không có FTM edge dithering (FRACVAL), nên phần lẻ được dither bằng
+ * phần mềm: ngắt reload cộng thêm 1 tick vào CnV ở frac/256 số chu kỳ. Ví dụ
+ * MOD = 399 (20 kHz ở 8 MHz) vẫn cho ~16 bit độ phân giải trung bình. Tốn một
+ * ngắt mỗi chu kỳ PWM khi phần lẻ khác 0; phần lẻ 0 thì như PWM_UpdateDuty_rs.
+ *
+ * @param dutyFine: Duty tính bằng tick << PWM_FRAC_BITS (tối đa là MOD << PWM_FRAC_BITS)
+ * @return status_t: STATUS_SUCCESS nếu thành công, STATUS_ERROR nếu sai
+ */
+status_t PWM_UpdateDutyFine_rs(uint8_t instanceIdx, uint8_t channel, uint32_t dutyFine);
+
+/**
+ * @brief Chuyển duty tuyến tính từ giá trị hiện tại tới duty trong periods chu kỳ PWM.
+ *
+ * Mỗi bước được nạp trong ngắt reload, CPU chỉ tính bước một lần khi gọi hàm.
+ *
+ * @param periods: Số chu kỳ PWM của ramp, 0 = đổi ngay như PWM_UpdateDuty_rs
+ * @return status_t: STATUS_SUCCESS nếu thành công, STATUS_ERROR nếu sai
+ */
+status_t PWM_RampDuty_rs(uint8_t instanceIdx, uint8_t channel, uint16_t duty, uint16_t periods);
+
+/**
+ * @brief true khi channel còn đang ramp.
+ */
+bool PWM_RampBusy(uint8_t instanceIdx, uint8_t channel);
+
 #endif /* PWM_H_ */
@@ -0,0 +1,228 @@
+#include <stddef.h>
+#include "S32K144.h"
+#include <edma_driver.h>
+#include "pwm.h"
+#include "pwm_wave.h"
+
+typedef struct {
+    uint8_t channel;
+    bool loop;
+    volatile bool playing;
+    const uint16_t *table;           // Table of the current pass
+    uint16_t length;
+    const uint16_t * volatile next;  // Queued table, NULL if none
+    volatile uint16_t next_length;
+} pwm_wave_t;
+
+static pwm_wave_t s_wave;
+static edma_chn_state_t s_dma_state;
+static edma_chn_state_t s_sync_dma_state;
+static uint32_t s_sync;  // FTM0 SYNC with SWSYNC, copied by the sync channel
+
+/*
+ * Point the TCD at a table: two bytes per request into CnV, and wrap back
+ * to the first entry when the major loop completes.
+ */
+static void PWM_WAVE_SetTable(const uint16_t *table, uint16_t length)
+{
+    EDMA_DRV_SetSrcAddr(PWM_WAVE_DMA_CHANNEL, (uint32_t)table);
+    EDMA_DRV_SetSrcLastAddrAdjustment(PWM_WAVE_DMA_CHANNEL, -((int32_t)length * 2));
+    EDMA_DRV_SetMajorLoopIterationCount(PWM_WAVE_DMA_CHANNEL, length);
+    s_wave.table = table;
+    s_wave.length = length;
+}
+
+/*
+ * Hand the channel back to PWM_UpdateDuty_rs: no DMA request, both eDMA
+ * channels free for the next start. The entry written last may still wait
+ * for the reload point, so it is written once more through the PWM layer,
+ * which also keeps its duty cache (ramp start point) right.
+ */
+static void PWM_WAVE_Release(uint16_t hold)
+{
+    FTM0->CONTROLS[s_wave.channel].CnSC &= ~(FTM_CnSC_DMA_MASK | FTM_CnSC_CHIE_MASK);
+    (void)EDMA_DRV_ReleaseChannel(PWM_WAVE_SYNC_DMA_CHANNEL);
+    (void)EDMA_DRV_ReleaseChannel(PWM_WAVE_DMA_CHANNEL);
+    s_wave.playing = false;
+    (void)PWM_UpdateDuty_rs(0U, s_wave.channel, hold);
+}
+
+/*
+ * Major loop complete, i.e. end of one pass. The next request is one PWM
+ * period away, which is the window to retarget the TCD or, for a one-shot
+ * playback, to stop the requests before the table starts over. Also called
+ * with EDMA_CHN_ERROR by either channel.
+ */
+static void PWM_WAVE_PassDone(void *parameter, edma_chn_status_t status)
+{
+    const uint16_t *next = s_wave.next;
+
+    (void)parameter;
+    if (status == EDMA_CHN_ERROR) {
+        PWM_WAVE_Stop();
+        return;
+    }
+    if (next != NULL) {
+        s_wave.next = NULL;
+        PWM_WAVE_SetTable(next, s_wave.next_length);
+    } else if (!s_wave.loop) {
+        PWM_WAVE_Release(s_wave.table[s_wave.length - 1U]);
+    }
+}
+
+status_t PWM_WAVE_Start(uint8_t channel, const uint16_t *table, uint16_t length, bool loop)
+{
+    edma_loop_transfer_config_t loopConfig = {
+        .majorLoopIterationCount = length,
+        .srcOffsetEnable = false,
+        .dstOffsetEnable = false,
+        .minorLoopOffset = 0,
+        .minorLoopChnLinkEnable = false,
+        .minorLoopChnLinkNumber = 0,
+        .majorLoopChnLinkEnable = false,
+        .majorLoopChnLinkNumber = 0
+    };
+    edma_transfer_config_t transferConfig = {
+        .srcAddr = (uint32_t)table,
+        .destAddr = (uint32_t)&FTM0->CONTROLS[channel].CnV,
+        .srcTransferSize = EDMA_TRANSFER_SIZE_2B,
+        .destTransferSize = EDMA_TRANSFER_SIZE_2B,
+        .srcOffset = 2,
+        .destOffset = 0,
+        .srcLastAddrAdjust = -((int32_t)length * 2),
+        .destLastAddrAdjust = 0,
+        .srcModulo = EDMA_MODULO_OFF,
+        .destModulo = EDMA_MODULO_OFF,
+        .minorByteTransferCount = 2,
+        .scatterGatherEnable = false,
+        .scatterGatherNextDescAddr = 0,
+        .interruptEnable = true,
+        .loopTransferConfig = &loopConfig
+    };
+    // One SYNC write per request, then the major-loop link starts the CnV copy
+    edma_loop_transfer_config_t syncLoopConfig = {
+        .majorLoopIterationCount = 1,
+        .srcOffsetEnable = false,
+        .dstOffsetEnable = false,
+        .minorLoopOffset = 0,
+        .minorLoopChnLinkEnable = false,
+        .minorLoopChnLinkNumber = 0,
+        .majorLoopChnLinkEnable = true,
+        .majorLoopChnLinkNumber = PWM_WAVE_DMA_CHANNEL
+    };
+    edma_transfer_config_t syncTransferConfig = {
+        .srcAddr = (uint32_t)&s_sync,
+        .destAddr = (uint32_t)&FTM0->SYNC,
+        .srcTransferSize = EDMA_TRANSFER_SIZE_4B,
+        .destTransferSize = EDMA_TRANSFER_SIZE_4B,
+        .srcOffset = 0,
+        .destOffset = 0,
+        .srcLastAddrAdjust = 0,
+        .destLastAddrAdjust = 0,
+        .srcModulo = EDMA_MODULO_OFF,
+        .destModulo = EDMA_MODULO_OFF,
+        .minorByteTransferCount = 4,
+        .scatterGatherEnable = false,
+        .scatterGatherNextDescAddr = 0,
+        .interruptEnable = false,
+        .loopTransferConfig = &syncLoopConfig
+    };
+    const edma_channel_config_t syncChannelConfig = {
+        .channelPriority = EDMA_CHN_DEFAULT_PRIORITY,
+        .virtChnConfig = PWM_WAVE_SYNC_DMA_CHANNEL,
+        .source = EDMA_REQ_FTM0_OR_CH0_CH7,
+        .callback = PWM_WAVE_PassDone,
+        .callbackParam = NULL,
+        .enableTrigger = false
+    };
+    // Started only through the link
+    const edma_channel_config_t channelConfig = {
+        .channelPriority = EDMA_CHN_DEFAULT_PRIORITY,
+        .virtChnConfig = PWM_WAVE_DMA_CHANNEL,
+        .source = EDMA_REQ_DISABLED,
+        .callback = PWM_WAVE_PassDone,
+        .callbackParam = NULL,
+        .enableTrigger = false
+    };
+    status_t status;
+
+    if ((table == NULL) || (length == 0U) || (length > 0x7FFFU) ||
+        (PWM_GetMod(0U) == 0U) || (channel >= PWM_CHANNEL_COUNT)) {
+        return STATUS_ERROR;
+    }
+    if (s_wave.playing) {
+        return STATUS_BUSY;
+    }
+    // Cancels any ramp or dither and checks the channel is a PWM channel
+    status = PWM_UpdateDuty_rs(0U, channel, table[0]);
+    if (status != STATUS_SUCCESS) {
+        return status;
+    }
+
+    status = EDMA_DRV_ChannelInit(&s_dma_state, &channelConfig);
+    if (status == STATUS_SUCCESS) {
+        status = EDMA_DRV_ChannelInit(&s_sync_dma_state, &syncChannelConfig);
+        if (status != STATUS_SUCCESS) {
+            (void)EDMA_DRV_ReleaseChannel(PWM_WAVE_DMA_CHANNEL);
+        }
+    }
+    if (status != STATUS_SUCCESS) {
+        return status;
+    }
+    // Only returns STATUS_SUCCESS
+    (void)EDMA_DRV_ConfigLoopTransfer(PWM_WAVE_DMA_CHANNEL, &transferConfig);
+    (void)EDMA_DRV_ConfigLoopTransfer(PWM_WAVE_SYNC_DMA_CHANNEL, &syncTransferConfig);
+    // The sync settings of the PWM layer, plus the software trigger
+    s_sync = FTM0->SYNC | FTM_SYNC_SWSYNC_MASK;
+
+    s_wave.channel = channel;
+    s_wave.table = table;
+    s_wave.length = length;
+    s_wave.loop = loop;
+    s_wave.next = NULL;
+    s_wave.playing = true;
+
+    /* The match flag requests the DMA (CHIE with DMA set routes it to eDMA,
+     * which also clears it). Each request sets SWSYNC, then copies the next
+     * entry: both land before the reload point, which loads the CnV buffer
+     * like any PWM_UpdateDuty_rs. PWMLOAD is not used, as a CHnSEL match
+     * would load all buffered registers, MOD included, mid-period. */
+    FTM0->CONTROLS[channel].CnSC &= ~FTM_CnSC_CHF_MASK;
+    FTM0->CONTROLS[channel].CnSC |= FTM_CnSC_DMA_MASK | FTM_CnSC_CHIE_MASK;
+
+    return EDMA_DRV_StartChannel(PWM_WAVE_SYNC_DMA_CHANNEL);
+}
+
+status_t PWM_WAVE_Queue(const uint16_t *table, uint16_t length)
+{
+    if ((table == NULL) || (length == 0U) || (length > 0x7FFFU)) {
+        return STATUS_ERROR;
+    }
+    if (!s_wave.playing) {
+        return STATUS_ERROR;
+    }
+    // Clear first so the pass-done interrupt never pairs a table with a stale length
+    s_wave.next = NULL;
+    s_wave.next_length = length;
+    s_wave.next = table;
+    return STATUS_SUCCESS;
+}
+
+void PWM_WAVE_Stop(void)
+{
+    uint32_t done;
+
+    if (s_wave.playing) {
+        // No more requests, so no more linked copies
+        (void)EDMA_DRV_StopChannel(PWM_WAVE_SYNC_DMA_CHANNEL);
+        s_wave.next = NULL;
+        // Entries copied in this pass; none yet means the last one of the previous pass
+        done = s_wave.length - EDMA_DRV_GetRemainingMajorIterationsCount(PWM_WAVE_DMA_CHANNEL);
+        PWM_WAVE_Release(s_wave.table[(done == 0U) ? (s_wave.length - 1U) : (done - 1U)]);
+    }
+}
+
+bool PWM_WAVE_IsPlaying(void)
+{
+    return s_wave.playing;
+}
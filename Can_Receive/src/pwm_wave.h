@@ -0,0 +1,61 @@
+#ifndef PWM_WAVE_H_
+#define PWM_WAVE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "status.h"
+
+/*
+ * Duty-cycle waveform playback on one FTM0 channel, fed by eDMA.
+ *
+ * Each PWM period the channel match raises the FTM0 DMA request. One eDMA
+ * channel sets SYNC[SWSYNC] and links to a second one that copies the next
+ * table entry into the CnV write buffer; the entry loads at the following
+ * reload point, as a PWM_UpdateDuty_rs would, so the CPU is not involved per
+ * period. An interrupt only runs at the end of each pass over the table, to
+ * swap in a queued table or to finish a one-shot playback, and must run
+ * within one PWM period.
+ *
+ * Other channels stay under pwm.h control and keep loading at the reload
+ * point only. As the player sets SWSYNC every period, a batch written
+ * through pwm.h right at a reload point may be split over two reloads.
+ *
+ * Table entries are CnV values and must not exceed MOD: a channel without
+ * a match in its period raises no DMA request and stalls the playback.
+ */
+
+#define PWM_WAVE_DMA_CHANNEL       (0U)  // eDMA virtual channel copying the table into CnV
+#define PWM_WAVE_SYNC_DMA_CHANNEL  (1U)  // eDMA virtual channel setting SWSYNC, requested by FTM0
+
+/**
+ * @brief Start playing a table on an FTM0 channel initialized by PWM_Init_Register.
+ *
+ * EDMA_DRV_Init must have been called. The channel keeps its current duty
+ * until the first entry is loaded, one to two PWM periods later. The table
+ * must stay valid while it is playing, and the channel must not be updated
+ * through pwm.h meanwhile.
+ *
+ * @param channel: FTM0 channel
+ * @param table: CnV values, one per PWM period
+ * @param length: Number of entries (1..32767)
+ * @param loop: true = repeat until stopped, false = play once and hold the last entry
+ * @return status_t: STATUS_BUSY if already playing, STATUS_ERROR on bad arguments
+ */
+status_t PWM_WAVE_Start(uint8_t channel, const uint16_t *table, uint16_t length, bool loop);
+
+/**
+ * @brief Replace the table at the end of the current pass, glitch-free.
+ *
+ * The new table starts right after the last entry of the current one. A
+ * table queued earlier and not started yet is replaced.
+ */
+status_t PWM_WAVE_Queue(const uint16_t *table, uint16_t length);
+
+/**
+ * @brief Stop immediately; the channel holds the entry written last.
+ */
+void PWM_WAVE_Stop(void);
+
+bool PWM_WAVE_IsPlaying(void);
+
+#endif /* PWM_WAVE_H_ */
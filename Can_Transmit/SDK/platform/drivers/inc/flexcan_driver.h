@@ -60,6 +60,8 @@ typedef enum {
 #if FEATURE_CAN_HAS_DMA_ENABLE
 	FLEXCAN_EVENT_DMA_COMPLETE,	  /*!< A complete transfer occurred on DMA */
 	FLEXCAN_EVENT_DMA_ERROR,	  /*!< A DMA transfer fail, because of a DMA channel error */
+    FLEXCAN_EVENT_RXFIFO_RING_HALF, /*!< The Rx FIFO ring filled up to its middle. */
+    FLEXCAN_EVENT_RXFIFO_RING_FULL, /*!< The Rx FIFO ring filled up to its end and wrapped. */
 #endif /* FEATURE_CAN_HAS_DMA_ENABLE */
     FLEXCAN_EVENT_ERROR
 } flexcan_event_type_t;
@@ -104,15 +106,83 @@ typedef struct {
     uint8_t dataLen;                    /*!< Length of data in bytes */
 } flexcan_msgbuff_t;
 
+/*! @brief Read-only view of a received frame still held in its locked message buffer.
+ *
+ * Only valid inside the flexcan_rx_view_callback_t it is passed to. The payload
+ * stays in FlexCAN RAM; read the bytes needed with FLEXCAN_DRV_ViewGetByte.
+ * Implements : flexcan_mb_view_t_Class
+ */
+typedef struct {
+    volatile const uint8_t *data;       /*!< Payload in FlexCAN RAM, big-endian 32-bit words */
+    uint32_t cs;                        /*!< Code and Status */
+    uint32_t msgId;                     /*!< Message Buffer ID */
+    uint16_t timestamp;                 /*!< Free running timer value at reception */
+    uint8_t dataLen;                    /*!< Length of data in bytes */
+    bool isExtended;                    /*!< True for an extended ID */
+} flexcan_mb_view_t;
+
+/*! @brief FlexCAN zero-copy receive callback function type
+ * Implements : flexcan_rx_view_callback_t_Class
+ */
+typedef void (*flexcan_rx_view_callback_t)(uint8_t instance, uint32_t buffIdx,
+                                           const flexcan_mb_view_t *view, void *callbackParam);
+
+/*!
+ * @brief Reads one payload byte of a zero-copy view.
+ *
+ * @param   view   The view passed to the callback
+ * @param   idx    Byte index, below view->dataLen
+ * @return  The payload byte
+ */
+static inline uint8_t FLEXCAN_DRV_ViewGetByte(const flexcan_mb_view_t *view, uint32_t idx)
+{
+    /* Bytes are stored most significant first within each word */
+    return view->data[(idx & ~3U) | (3U - (idx & 3U))];
+}
+
+/*! @brief Software queue of a continuous-receive message buffer.
+ *
+ * Filled by the interrupt handler and emptied by FLEXCAN_DRV_ReadRxQueue.
+ * The counters may be read by the application at any time.
+ * Implements : flexcan_rx_queue_t_Class
+ */
+typedef struct {
+    flexcan_msgbuff_t *frames;           /*!< Caller-supplied storage of size frames */
+    uint16_t size;                       /*!< Number of frames, a power of two */
+    volatile uint16_t head;              /*!< Frames written, free-running */
+    volatile uint16_t tail;              /*!< Frames read, free-running */
+    volatile uint32_t received;          /*!< Frames queued since the MB was armed */
+    volatile uint32_t overflows;         /*!< Frames dropped because the queue was full */
+} flexcan_rx_queue_t;
+
+#if FEATURE_CAN_HAS_DMA_ENABLE
+/*! @brief Circular buffer the Rx FIFO is streamed into by eDMA.
+ *
+ * The eDMA channel moves every frame without CPU involvement and wraps at the
+ * end of the ring; it only interrupts at the half and full marks. Entries hold
+ * the raw FIFO output until FLEXCAN_DRV_ReadRxFifoRing converts them.
+ * Implements : flexcan_rx_fifo_ring_t_Class
+ */
+typedef struct {
+    flexcan_msgbuff_t *frames;           /*!< Caller-supplied storage of size frames */
+    uint16_t size;                       /*!< Number of frames, a power of two */
+    volatile uint32_t produced;          /*!< Frames written as of the last notification */
+    volatile uint32_t consumed;          /*!< Frames read, free-running consumer index */
+    volatile uint32_t overruns;          /*!< Frames skipped because the ring was lapped */
+} flexcan_rx_fifo_ring_t;
+#endif /* FEATURE_CAN_HAS_DMA_ENABLE */
+
 /*! @brief Information needed for internal handling of a given MB.
  * Implements : flexcan_mb_handle_t_Class
  */
 typedef struct {
     flexcan_msgbuff_t *mb_message;       /*!< The FlexCAN MB structure */
+    flexcan_rx_queue_t *rxQueue;         /*!< Continuous-receive queue, NULL for single frames */
     semaphore_t mbSema;                  /*!< Semaphore used for signaling completion of a blocking transfer */
     volatile flexcan_mb_state_t state;   /*!< The state of the current MB (idle/Rx busy/Tx busy) */
     bool isBlocking;                     /*!< True if the transfer is blocking */
     bool isRemote;                       /*!< True if the frame is a remote frame */
+    bool isZeroCopy;                     /*!< True if frames are handed out in place */
 } flexcan_mb_handle_t;
 
 /*!
@@ -143,8 +213,15 @@ typedef struct FlexCANState {
 #if FEATURE_CAN_HAS_DMA_ENABLE
     uint8_t rxFifoDMAChannel;                                  /*!< DMA channel number used for
                                                                     transfers. */
+    flexcan_rx_fifo_ring_t *rxFifoRing;                        /*!< Rx FIFO streaming ring, NULL if
+                                                                    not streaming. */
 #endif
     flexcan_rxfifo_transfer_type_t transferType;               /*!< Type of RxFIFO transfer. */
+    struct FlexCANTxQueue *txQueue;                            /*!< Transmit priority queue, NULL if
+                                                                    not configured. */
+    flexcan_rx_view_callback_t rxViewCallback;                 /*!< Zero-copy receive callback. */
+    void *rxViewCallbackParam;                                 /*!< Parameter passed to the zero-copy
+                                                                    receive callback. */
 } flexcan_state_t;
 
 /*! @brief FlexCAN data info from user
@@ -162,6 +239,41 @@ typedef struct {
     bool is_remote;                         /*!< Specifies if the frame is standard or remote */
 } flexcan_data_info_t;
 
+/*! @brief Order in which pending Tx message buffers are sent.
+ * Implements : flexcan_tx_arbitration_t_Class
+ */
+typedef enum {
+    FLEXCAN_TX_ARB_LOWEST_ID = 0U,  /*!< The MB with the lowest CAN ID (highest bus priority) first */
+    FLEXCAN_TX_ARB_LOWEST_MB = 1U   /*!< The lowest numbered MB first */
+} flexcan_tx_arbitration_t;
+
+/*! @brief Frame waiting in a transmit queue.
+ * Implements : flexcan_tx_entry_t_Class
+ */
+typedef struct {
+    flexcan_data_info_t info;               /*!< Frame format */
+    uint32_t msgId;                         /*!< CAN ID */
+    uint32_t key;                           /*!< Bus arbitration key, lower wins */
+    uint32_t seq;                           /*!< Enqueue order, keeps frames with equal IDs in order */
+    uint8_t data[64];                       /*!< Payload */
+} flexcan_tx_entry_t;
+
+/*! @brief Transmit priority queue, a bounded binary min-heap on bus priority.
+ *
+ * Frames wait here until one of the message buffers in mbMask is free. The
+ * counters may be read by the application at any time.
+ * Implements : flexcan_tx_queue_t_Class
+ */
+typedef struct FlexCANTxQueue {
+    flexcan_tx_entry_t *entries;            /*!< Caller-supplied storage, in heap order */
+    uint16_t capacity;                      /*!< Number of entries */
+    volatile uint16_t count;                /*!< Frames waiting */
+    uint32_t mbMask;                        /*!< Bit n: MB n is fed by the queue (MB 0-31) */
+    uint32_t seq;                           /*!< Next enqueue sequence number */
+    volatile uint32_t sent;                 /*!< Frames handed to a message buffer */
+    volatile uint32_t rejected;             /*!< Frames refused: queue full, or rejected by the controller */
+} flexcan_tx_queue_t;
+
 /*! @brief FlexCAN Rx FIFO filters number
  * Implements : flexcan_rx_fifo_id_filter_num_t_Class
  */
@@ -655,6 +767,61 @@ status_t FLEXCAN_DRV_Send(
     uint32_t msg_id,
     const uint8_t *mb_data);
 
+/*!
+ * @brief Attaches a transmit priority queue to the driver.
+ *
+ * FLEXCAN_DRV_SendQueued then places frames into the message buffers in mbMask,
+ * always the highest bus priority frame first, and the Tx complete interrupt
+ * refills a message buffer as soon as it is free. The message buffers must
+ * not be used with FLEXCAN_DRV_Send meanwhile. Select FLEXCAN_TX_ARB_LOWEST_ID
+ * with FLEXCAN_DRV_SetTxArbitration so the controller also sends the loaded
+ * message buffers in ID order.
+ *
+ * @param   instance   A FlexCAN instance number
+ * @param   queue      Queue state, must stay valid while attached; NULL detaches the queue
+ * @param   entries    Queue storage
+ * @param   capacity   Number of entries in storage
+ * @param   mbMask     Bit n selects MB n (0-31) for transmission
+ * @return  STATUS_SUCCESS if successful;
+ *          STATUS_CAN_BUFF_OUT_OF_RANGE if mbMask selects an invalid message buffer;
+ *          STATUS_ERROR if the storage or mbMask is empty
+ */
+status_t FLEXCAN_DRV_ConfigTxQueue(
+    uint8_t instance,
+    flexcan_tx_queue_t *queue,
+    flexcan_tx_entry_t *entries,
+    uint16_t capacity,
+    uint32_t mbMask);
+
+/*!
+ * @brief Queues a CAN frame for transmission in bus priority order.
+ *
+ * The function returns immediately; the frame is sent from the first free
+ * message buffer of the queue once no frame of higher priority is waiting.
+ * Frames with the same ID are sent in the order they were queued.
+ *
+ * @param   instance   A FlexCAN instance number
+ * @param   tx_info    Data info
+ * @param   msg_id     ID of the message to transmit
+ * @param   mb_data    Bytes of the FlexCAN message, copied into the queue
+ * @return  STATUS_SUCCESS if successful;
+ *          STATUS_BUSY if the queue is full;
+ *          STATUS_ERROR if no queue is attached
+ */
+status_t FLEXCAN_DRV_SendQueued(
+    uint8_t instance,
+    const flexcan_data_info_t *tx_info,
+    uint32_t msg_id,
+    const uint8_t *mb_data);
+
+/*!
+ * @brief Selects the order in which pending Tx message buffers are sent.
+ *
+ * @param   instance      A FlexCAN instance number
+ * @param   arbitration   Lowest CAN ID first or lowest message buffer first
+ */
+void FLEXCAN_DRV_SetTxArbitration(uint8_t instance, flexcan_tx_arbitration_t arbitration);
+
 /*@}*/
 
 /*!
@@ -753,6 +920,70 @@ status_t FLEXCAN_DRV_Receive(
     uint8_t mb_idx,
     flexcan_msgbuff_t *data);
 
+/*!
+ * @brief Receives CAN frames continuously using the specified message buffer.
+ *
+ * The message buffer stays armed until FLEXCAN_DRV_AbortTransfer is called.
+ * Every frame is copied into the queue by the interrupt handler, then the
+ * callback (if installed) is invoked with FLEXCAN_EVENT_RX_COMPLETE. Frames
+ * arriving while the queue is full are dropped and counted in overflows.
+ *
+ * @param   instance   A FlexCAN instance number
+ * @param   mb_idx     Index of the message buffer, configured with FLEXCAN_DRV_ConfigRxMb
+ * @param   queue      Queue state, must stay valid while the MB is armed
+ * @param   frames     Queue storage
+ * @param   size       Number of frames in storage, a power of two up to 32768
+ * @return  STATUS_SUCCESS if successful;
+ *          STATUS_CAN_BUFF_OUT_OF_RANGE if the index of a message buffer is invalid;
+ *          STATUS_BUSY if a resource is busy;
+ *          STATUS_ERROR if size is not a power of two
+ */
+status_t FLEXCAN_DRV_ReceiveContinuous(
+    uint8_t instance,
+    uint8_t mb_idx,
+    flexcan_rx_queue_t *queue,
+    flexcan_msgbuff_t *frames,
+    uint16_t size);
+
+/*!
+ * @brief Receives CAN frames in place, without copying them out of the message buffer.
+ *
+ * The message buffer stays armed until FLEXCAN_DRV_AbortTransfer is called.
+ * For every frame the callback installed with FLEXCAN_DRV_InstallRxViewCallback
+ * is invoked from the interrupt while the message buffer is locked, and gets a
+ * view of the ID, DLC, time stamp and payload; the message buffer is released
+ * when the callback returns. Keep the callback short: a message buffer locked
+ * for long cannot take the next frame.
+ *
+ * @param   instance   A FlexCAN instance number
+ * @param   mb_idx     Index of the message buffer, configured with FLEXCAN_DRV_ConfigRxMb
+ * @return  STATUS_SUCCESS if successful;
+ *          STATUS_CAN_BUFF_OUT_OF_RANGE if the index of a message buffer is invalid;
+ *          STATUS_BUSY if a resource is busy;
+ *          STATUS_ERROR if no zero-copy callback is installed
+ */
+status_t FLEXCAN_DRV_ReceiveZeroCopy(
+    uint8_t instance,
+    uint8_t mb_idx);
+
+/*!
+ * @brief Takes frames out of the queue of a continuous-receive message buffer.
+ *
+ * Must not be called concurrently for the same MB. Frames still queued after
+ * FLEXCAN_DRV_AbortTransfer can be read until the MB is armed again.
+ *
+ * @param   instance   A FlexCAN instance number
+ * @param   mb_idx     Index of the message buffer
+ * @param   data       Destination of up to count frames, oldest first
+ * @param   count      Maximum number of frames to read
+ * @return  Number of frames read, 0 if the queue is empty or the MB has no queue
+ */
+uint32_t FLEXCAN_DRV_ReadRxQueue(
+    uint8_t instance,
+    uint8_t mb_idx,
+    flexcan_msgbuff_t *data,
+    uint32_t count);
+
 /*!
  * @brief Receives a CAN frame using the message FIFO, in a blocking manner.
  *
@@ -789,6 +1020,51 @@ status_t FLEXCAN_DRV_RxFifo(
     uint8_t instance,
     flexcan_msgbuff_t *data);
 
+#if FEATURE_CAN_HAS_DMA_ENABLE
+/*!
+ * @brief Streams the Rx FIFO into a ring buffer using eDMA.
+ *
+ * Requires the driver to be initialized with FLEXCAN_RXFIFO_USING_DMA. The eDMA
+ * channel copies every frame into the next ring entry and wraps at the end, until
+ * FLEXCAN_DRV_AbortTransfer is called for FLEXCAN_MB_HANDLE_RXFIFO (0). The
+ * callback is invoked with FLEXCAN_EVENT_RXFIFO_RING_HALF and
+ * FLEXCAN_EVENT_RXFIFO_RING_FULL each time size / 2 frames have arrived; frames
+ * can be read with FLEXCAN_DRV_ReadRxFifoRing at any time in between.
+ *
+ * @param   instance   A FlexCAN instance number
+ * @param   ring       Ring state, owned by the driver until the stream is stopped
+ * @param   frames     Storage of size frames
+ * @param   size       Number of frames, a power of two from 2 to 16384
+ * @return  STATUS_SUCCESS if successful;
+ *          STATUS_BUSY if a resource is busy;
+ *          STATUS_ERROR if the size is invalid, the Rx FIFO is not enabled or
+ *          not in DMA mode
+ */
+status_t FLEXCAN_DRV_RxFifoContinuous(
+    uint8_t instance,
+    flexcan_rx_fifo_ring_t *ring,
+    flexcan_msgbuff_t *frames,
+    uint16_t size);
+
+/*!
+ * @brief Takes frames out of the Rx FIFO ring.
+ *
+ * Frames are returned in the same format as FLEXCAN_DRV_RxFifo produces. If the
+ * eDMA lapped the consumer, before or while the frames were copied, the
+ * overwritten frames are skipped and counted in ring->overruns. Must not be
+ * called concurrently.
+ *
+ * @param   instance   A FlexCAN instance number
+ * @param   data       Destination of up to count frames, oldest first
+ * @param   count      Maximum number of frames to read
+ * @return  Number of frames read, 0 if the ring is empty or not streaming
+ */
+uint32_t FLEXCAN_DRV_ReadRxFifoRing(
+    uint8_t instance,
+    flexcan_msgbuff_t *data,
+    uint32_t count);
+#endif /* FEATURE_CAN_HAS_DMA_ENABLE */
+
 /*@}*/
 
 /*!
@@ -849,6 +1125,17 @@ void FLEXCAN_DRV_InstallEventCallback(uint8_t instance,
                                       flexcan_callback_t callback,
                                       void *callbackParam);
 
+/*!
+ * @brief Installs the callback of message buffers armed with FLEXCAN_DRV_ReceiveZeroCopy.
+ *
+ * @param instance The FlexCAN instance number.
+ * @param callback The zero-copy receive callback function, NULL to drop such frames.
+ * @param callbackParam User parameter passed to the callback function.
+ */
+void FLEXCAN_DRV_InstallRxViewCallback(uint8_t instance,
+                                       flexcan_rx_view_callback_t callback,
+                                       void *callbackParam);
+
 /*!
  * @brief Installs an error callback function for the IRQ handler and enables error interrupts.
  *
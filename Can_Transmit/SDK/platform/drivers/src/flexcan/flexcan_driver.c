@@ -70,6 +70,18 @@
 
 #define FLEXCAN_MB_HANDLE_RXFIFO    0U
 
+/* IFLAG/IMASK registers covering all message buffers */
+#define FLEXCAN_MB_FLAG_WORDS       ((FEATURE_CAN_MAX_MB_NUM + 31U) / 32U)
+/* Frames the RX FIFO can hold, bounds the drain loop of one interrupt */
+#define FLEXCAN_RXFIFO_DEPTH        6U
+/* Orders continuous-receive queue data against its indices (host builds,
+ * tests/, provide their own) */
+#ifndef FLEXCAN_QUEUE_BARRIER
+#define FLEXCAN_QUEUE_BARRIER()     __asm volatile ("dmb" : : : "memory")
+#endif
+/* Bytes of one frame read from the Rx FIFO output: CS, ID and 8 data bytes */
+#define FLEXCAN_RXFIFO_FRAME_BYTES  16U
+
 /* CAN bit timing values */
 #define FLEXCAN_NUM_TQ_MIN     8U
 #define FLEXCAN_NUM_TQ_MAX    26U
@@ -117,6 +129,7 @@ static status_t FLEXCAN_StartRxMessageBufferData(
                     uint8_t instance,
                     uint8_t mb_idx,
                     flexcan_msgbuff_t *data,
+                    flexcan_rx_queue_t *queue,
                     bool isBlocking
                     );
 static status_t FLEXCAN_StartRxMessageFifoData(
@@ -127,6 +140,10 @@ static status_t FLEXCAN_StartRxMessageFifoData(
 static void FLEXCAN_CompleteTransfer(uint8_t instance, uint32_t mb_idx);
 static void FLEXCAN_CompleteRxMessageFifoData(uint8_t instance);
 #if FEATURE_CAN_HAS_DMA_ENABLE
+static void FLEXCAN_RxFifoRingDMA(void *parameter,
+                                  edma_chn_status_t status);
+static status_t FLEXCAN_ConfigRxFifoRingDMA(uint8_t instance);
+static inline void FLEXCAN_FixupRxFifoFrame(flexcan_msgbuff_t *frame);
 static void FLEXCAN_CompleteRxFifoDataDMA(void *parameter,
                                           edma_chn_status_t status);
 #endif
@@ -135,6 +152,9 @@ static uint32_t FLEXCAN_BitrateToTimeSeg(uint32_t bitrate,
                                          flexcan_time_segment_t * timeSeg);
 static inline void FLEXCAN_IRQHandlerRxFIFO(uint8_t instance, uint32_t mb_idx);
 static void FLEXCAN_IRQHandlerRxMB(uint8_t instance, uint32_t mb_idx);
+static void FLEXCAN_IRQHandlerTxMB(uint8_t instance, uint32_t mb_idx);
+static inline uint32_t FLEXCAN_LowestSetBit(uint32_t value);
+static void FLEXCAN_TxQueueRefill(uint8_t instance);
 static inline void FLEXCAN_EnableIRQs(uint8_t instance);
 #ifdef ERRATA_E10368
 #if FEATURE_CAN_HAS_FD
@@ -848,6 +868,8 @@ status_t FLEXCAN_DRV_Init(
         }
         state->mbs[i].isBlocking = false;
         state->mbs[i].mb_message = NULL;
+        state->mbs[i].rxQueue = NULL;
+        state->mbs[i].isZeroCopy = false;
         state->mbs[i].state = FLEXCAN_MB_IDLE;
     }
 #if FEATURE_CAN_HAS_MEM_ERR_DET
@@ -858,6 +880,7 @@ status_t FLEXCAN_DRV_Init(
     state->transferType = data->transfer_type;
 #if FEATURE_CAN_HAS_DMA_ENABLE
     state->rxFifoDMAChannel = data->rxFifoDMAChannel;
+    state->rxFifoRing = NULL;
 #endif
 
     /* Clear Callbacks in case of autovariables garbage */
@@ -865,6 +888,9 @@ status_t FLEXCAN_DRV_Init(
     state->callbackParam = NULL;
     state->error_callback = NULL;
     state->errorCallbackParam = NULL;
+    state->txQueue = NULL;
+    state->rxViewCallback = NULL;
+    state->rxViewCallbackParam = NULL;
 
     /* Save runtime structure pointers so irq handler can point to the correct state structure */
     g_flexcanStatePtr[instance] = state;
@@ -1096,6 +1122,374 @@ status_t FLEXCAN_DRV_Send(
     return result;
 }
 
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_TxArbitrationKey
+ * Description   : Key that orders frames the way bus arbitration does: the
+ * 11-bit base ID first, then a standard frame before an extended one, then
+ * the 18-bit ID extension.
+ *
+ *END**************************************************************************/
+static inline uint32_t FLEXCAN_TxArbitrationKey(flexcan_msgbuff_id_type_t idType, uint32_t msg_id)
+{
+    uint32_t key;
+
+    if (idType == FLEXCAN_MSG_ID_EXT)
+    {
+        key = ((msg_id & 0x1FFC0000U) << 1U) | 0x40000U | (msg_id & 0x3FFFFU);
+    }
+    else
+    {
+        key = (msg_id & 0x7FFU) << 19U;
+    }
+    return key;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_TxEntryBefore
+ * Description   : True if a frame with key/seq is sent before entry.
+ *
+ *END**************************************************************************/
+static inline bool FLEXCAN_TxEntryBefore(uint32_t key, uint32_t seq, const flexcan_tx_entry_t *entry)
+{
+    return (key < entry->key) || ((key == entry->key) && ((int32_t)(seq - entry->seq) < 0));
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_TxQueuePush
+ * Description   : Insert a frame into the heap (sift up). The queue must not
+ * be full.
+ *
+ *END**************************************************************************/
+static void FLEXCAN_TxQueuePush(flexcan_tx_queue_t *queue,
+                                const flexcan_data_info_t *tx_info,
+                                uint32_t msg_id,
+                                const uint8_t *mb_data)
+{
+    uint32_t key = FLEXCAN_TxArbitrationKey(tx_info->msg_id_type, msg_id);
+    uint32_t seq = queue->seq;
+    uint32_t hole = queue->count;
+    flexcan_tx_entry_t *entry;
+    uint32_t i;
+
+    while (hole > 0U)
+    {
+        uint32_t parent = (hole - 1U) / 2U;
+
+        if (!FLEXCAN_TxEntryBefore(key, seq, &queue->entries[parent]))
+        {
+            break;
+        }
+        queue->entries[hole] = queue->entries[parent];
+        hole = parent;
+    }
+
+    entry = &queue->entries[hole];
+    entry->info = *tx_info;
+    entry->msgId = msg_id;
+    entry->key = key;
+    entry->seq = seq;
+    if (mb_data != NULL)
+    {
+        for (i = 0U; i < tx_info->data_length; i++)
+        {
+            entry->data[i] = mb_data[i];
+        }
+    }
+    queue->seq = seq + 1U;
+    queue->count++;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_TxQueuePop
+ * Description   : Remove the first frame of the heap (sift down). The queue
+ * must not be empty.
+ *
+ *END**************************************************************************/
+static void FLEXCAN_TxQueuePop(flexcan_tx_queue_t *queue)
+{
+    uint32_t count = (uint32_t)queue->count - 1U;
+    uint32_t hole = 0U;
+    flexcan_tx_entry_t last;
+
+    queue->count = (uint16_t)count;
+    if (count == 0U)
+    {
+        return;
+    }
+    last = queue->entries[count];
+
+    for (;;)
+    {
+        uint32_t child = (2U * hole) + 1U;
+
+        if (child >= count)
+        {
+            break;
+        }
+        if (((child + 1U) < count) &&
+            FLEXCAN_TxEntryBefore(queue->entries[child + 1U].key, queue->entries[child + 1U].seq,
+                                  &queue->entries[child]))
+        {
+            child++;
+        }
+        if (!FLEXCAN_TxEntryBefore(queue->entries[child].key, queue->entries[child].seq, &last))
+        {
+            break;
+        }
+        queue->entries[hole] = queue->entries[child];
+        hole = child;
+    }
+    queue->entries[hole] = last;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_TxQueueKeyPending
+ * Description   : True if a busy message buffer of the queue still holds a
+ * frame with the given arbitration key. The controller sends equal IDs from
+ * the lowest message buffer first, which is not the queue order.
+ *
+ *END**************************************************************************/
+static bool FLEXCAN_TxQueueKeyPending(uint8_t instance, uint32_t key)
+{
+    CAN_Type * base = g_flexcanBase[instance];
+    const flexcan_state_t * state = g_flexcanStatePtr[instance];
+    uint32_t bits = state->txQueue->mbMask;
+
+    while (bits != 0U)
+    {
+        uint8_t mb_idx = (uint8_t)FLEXCAN_LowestSetBit(bits);
+
+        bits &= bits - 1U;
+        if (state->mbs[mb_idx].state != FLEXCAN_MB_IDLE)
+        {
+            volatile const uint32_t *flexcan_mb = FLEXCAN_GetMsgBuffRegion(base, mb_idx);
+            uint32_t cs = flexcan_mb[0];
+            uint32_t id = flexcan_mb[1];
+            uint32_t mb_key;
+
+            if ((cs & CAN_CS_IDE_MASK) != 0U)
+            {
+                mb_key = FLEXCAN_TxArbitrationKey(FLEXCAN_MSG_ID_EXT, id & (CAN_ID_STD_MASK | CAN_ID_EXT_MASK));
+            }
+            else
+            {
+                mb_key = FLEXCAN_TxArbitrationKey(FLEXCAN_MSG_ID_STD, (id & CAN_ID_STD_MASK) >> CAN_ID_STD_SHIFT);
+            }
+            if (mb_key == key)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_TxQueueRefill
+ * Description   : Move frames from the queue into its idle message buffers,
+ * highest priority first. A frame waits while an earlier frame with the same
+ * ID is still pending. Called from the Tx complete interrupt, or with the
+ * message buffer interrupts disabled.
+ *
+ *END**************************************************************************/
+static void FLEXCAN_TxQueueRefill(uint8_t instance)
+{
+    CAN_Type * base = g_flexcanBase[instance];
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+    flexcan_tx_queue_t * queue = state->txQueue;
+    uint32_t bits;
+
+    if (queue == NULL)
+    {
+        return;
+    }
+
+    bits = queue->mbMask;
+    while ((queue->count != 0U) && (bits != 0U))
+    {
+        uint8_t mb_idx = (uint8_t)FLEXCAN_LowestSetBit(bits);
+        const flexcan_tx_entry_t *entry = &queue->entries[0];
+
+        bits &= bits - 1U;
+        if (state->mbs[mb_idx].state != FLEXCAN_MB_IDLE)
+        {
+            continue;
+        }
+        if (FLEXCAN_TxQueueKeyPending(instance, entry->key))
+        {
+            /* Loaded into a lower MB it could overtake the pending frame */
+            break;
+        }
+        if (FLEXCAN_StartSendData(instance, mb_idx, &entry->info, entry->msgId, entry->data, false) == STATUS_SUCCESS)
+        {
+            /* Enable message buffer interrupt*/
+            (void)FLEXCAN_SetMsgBuffIntCmd(base, mb_idx, true);
+            queue->sent++;
+        }
+        else
+        {
+            queue->rejected++;
+        }
+        /* A frame the controller refuses would block the queue forever */
+        FLEXCAN_TxQueuePop(queue);
+    }
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_SetMbIRQs
+ * Description   : Enable or disable the message buffer interrupts of an
+ * instance; keeps the Tx queue consistent while the application changes it.
+ *
+ *END**************************************************************************/
+static inline void FLEXCAN_SetMbIRQs(uint8_t instance, bool enable)
+{
+    uint8_t i;
+
+    for (i = 0; i < FEATURE_CAN_MB_IRQS_MAX_COUNT; i++)
+    {
+        if (g_flexcanOredMessageBufferIrqId[i][instance] != NotAvail_IRQn)
+        {
+            if (enable)
+            {
+                INT_SYS_EnableIRQ(g_flexcanOredMessageBufferIrqId[i][instance]);
+            }
+            else
+            {
+                INT_SYS_DisableIRQ(g_flexcanOredMessageBufferIrqId[i][instance]);
+            }
+        }
+    }
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_ConfigTxQueue
+ * Description   : Attach (or detach, with queue = NULL) a transmit priority
+ * queue feeding the message buffers in mbMask.
+ *
+ * Implements    : FLEXCAN_DRV_ConfigTxQueue_Activity
+ *END**************************************************************************/
+status_t FLEXCAN_DRV_ConfigTxQueue(
+    uint8_t instance,
+    flexcan_tx_queue_t *queue,
+    flexcan_tx_entry_t *entries,
+    uint16_t capacity,
+    uint32_t mbMask)
+{
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+
+    const CAN_Type * base = g_flexcanBase[instance];
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+    uint32_t bits = mbMask;
+
+    if (queue != NULL)
+    {
+        if ((entries == NULL) || (capacity == 0U) || (mbMask == 0U))
+        {
+            return STATUS_ERROR;
+        }
+        while (bits != 0U)
+        {
+            if (FLEXCAN_IsOutOfRangeMbIdx(base, (uint8_t)FLEXCAN_LowestSetBit(bits)))
+            {
+                return STATUS_CAN_BUFF_OUT_OF_RANGE;
+            }
+            bits &= bits - 1U;
+        }
+        queue->entries = entries;
+        queue->capacity = capacity;
+        queue->count = 0U;
+        queue->mbMask = mbMask;
+        queue->seq = 0U;
+        queue->sent = 0U;
+        queue->rejected = 0U;
+    }
+
+    FLEXCAN_SetMbIRQs(instance, false);
+    state->txQueue = queue;
+    FLEXCAN_SetMbIRQs(instance, true);
+
+    return STATUS_SUCCESS;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_SendQueued
+ * Description   : Queue a frame for transmission in bus priority order and
+ * load it into a message buffer right away if one is free.
+ *
+ * Implements    : FLEXCAN_DRV_SendQueued_Activity
+ *END**************************************************************************/
+status_t FLEXCAN_DRV_SendQueued(
+    uint8_t instance,
+    const flexcan_data_info_t *tx_info,
+    uint32_t msg_id,
+    const uint8_t *mb_data)
+{
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(tx_info != NULL);
+    DEV_ASSERT(tx_info->data_length <= 64U);
+
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+    flexcan_tx_queue_t * queue = state->txQueue;
+    status_t result = STATUS_SUCCESS;
+
+    if (queue == NULL)
+    {
+        return STATUS_ERROR;
+    }
+
+    FLEXCAN_SetMbIRQs(instance, false);
+    if (queue->count >= queue->capacity)
+    {
+        queue->rejected++;
+        result = STATUS_BUSY;
+    }
+    else
+    {
+        FLEXCAN_TxQueuePush(queue, tx_info, msg_id, mb_data);
+        FLEXCAN_TxQueueRefill(instance);
+    }
+    FLEXCAN_SetMbIRQs(instance, true);
+
+    return result;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_SetTxArbitration
+ * Description   : Select whether the controller sends the pending message
+ * buffer with the lowest CAN ID or the lowest number first.
+ *
+ * Implements    : FLEXCAN_DRV_SetTxArbitration_Activity
+ *END**************************************************************************/
+void FLEXCAN_DRV_SetTxArbitration(uint8_t instance, flexcan_tx_arbitration_t arbitration)
+{
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+
+    CAN_Type * base = g_flexcanBase[instance];
+    bool freeze = FLEXCAN_GetFreezeMode(base);
+
+    if (freeze == false)
+    {
+        FLEXCAN_EnterFreezeMode(base);
+    }
+
+    FLEXCAN_SetLowestBufferFirst(base, (arbitration == FLEXCAN_TX_ARB_LOWEST_MB));
+
+    if (freeze == false)
+    {
+        FLEXCAN_ExitFreezeMode(base);
+    }
+}
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_DRV_ConfigMb
@@ -1224,7 +1618,7 @@ status_t FLEXCAN_DRV_ReceiveBlocking(
         return STATUS_CAN_BUFF_OUT_OF_RANGE;
     }
 
-    result = FLEXCAN_StartRxMessageBufferData(instance, mb_idx, data, true);
+    result = FLEXCAN_StartRxMessageBufferData(instance, mb_idx, data, NULL, true);
 
     if(result == STATUS_SUCCESS)
     {
@@ -1281,58 +1675,179 @@ status_t FLEXCAN_DRV_Receive(
         return STATUS_CAN_BUFF_OUT_OF_RANGE;
     }
 
-    result = FLEXCAN_StartRxMessageBufferData(instance, mb_idx, data, false);
+    result = FLEXCAN_StartRxMessageBufferData(instance, mb_idx, data, NULL, false);
 
     return result;
 }
 
 /*FUNCTION**********************************************************************
  *
- * Function Name : FLEXCAN_DRV_RxFifoBlocking
- * Description   : This function receives a CAN frame using the Rx FIFO. The
- * function blocks until either a frame was received, or the specified timeout
- * expired.
+ * Function Name : FLEXCAN_DRV_ReceiveContinuous
+ * Description   : This function arms a message buffer for continuous reception.
+ * Each received frame is queued by the interrupt handler and the message buffer
+ * stays armed; frames are taken out with FLEXCAN_DRV_ReadRxQueue.
  *
- * Implements    : FLEXCAN_DRV_RxFifoBlocking_Activity
+ * Implements    : FLEXCAN_DRV_ReceiveContinuous_Activity
  *END**************************************************************************/
-status_t FLEXCAN_DRV_RxFifoBlocking(
+status_t FLEXCAN_DRV_ReceiveContinuous(
     uint8_t instance,
-    flexcan_msgbuff_t *data,
-    uint32_t timeout_ms)
+    uint8_t mb_idx,
+    flexcan_rx_queue_t *queue,
+    flexcan_msgbuff_t *frames,
+    uint16_t size)
 {
     DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
-
-    status_t result;
+    DEV_ASSERT(queue != NULL);
+    DEV_ASSERT(frames != NULL);
+    const CAN_Type * base = g_flexcanBase[instance];
     flexcan_state_t * state = g_flexcanStatePtr[instance];
-    CAN_Type * base = g_flexcanBase[instance];
-
-    result = FLEXCAN_StartRxMessageFifoData(instance, data, true);
 
-    if (result == STATUS_SUCCESS)
+    /* Check if the MB index is in range */
+    if (FLEXCAN_IsOutOfRangeMbIdx(base, mb_idx))
     {
-        result = OSIF_SemaWait(&state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].mbSema, timeout_ms);
+        return STATUS_CAN_BUFF_OUT_OF_RANGE;
+    }
+    /* Power of two: indices wrap with a mask, and head - tail stays exact */
+    if ((size == 0U) || ((size & (size - 1U)) != 0U) || (size > 0x8000U))
+    {
+        return STATUS_ERROR;
+    }
+    /* Do not pull the storage from under a queue still in use */
+    if (state->mbs[mb_idx].state != FLEXCAN_MB_IDLE)
+    {
+        return STATUS_BUSY;
+    }
 
-        if (state->transferType == FLEXCAN_RXFIFO_USING_INTERRUPTS)
-        {
-            /* Disable RX FIFO interrupts*/
-            (void)FLEXCAN_SetMsgBuffIntCmd(base, FEATURE_CAN_RXFIFO_FRAME_AVAILABLE, false);
-            (void)FLEXCAN_SetMsgBuffIntCmd(base, FEATURE_CAN_RXFIFO_WARNING, false);
-            (void)FLEXCAN_SetMsgBuffIntCmd(base, FEATURE_CAN_RXFIFO_OVERFLOW, false);
-        }
-#if FEATURE_CAN_HAS_DMA_ENABLE
-        else
-        {
-            /* This function always return status success */
-            (void)EDMA_DRV_StopChannel(state->rxFifoDMAChannel);
-        }
-#endif
+    queue->frames = frames;
+    queue->size = size;
 
-        if (result == STATUS_TIMEOUT)
-        {
-             /* If the status is updated reception successful else report TimeOut */
-            if (state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].state == FLEXCAN_MB_IDLE)
-            {
-                result = STATUS_SUCCESS;
+    return FLEXCAN_StartRxMessageBufferData(instance, mb_idx, NULL, queue, false);
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_ReceiveZeroCopy
+ * Description   : This function arms a message buffer for continuous reception
+ * without copying: each frame is passed in place to the zero-copy callback.
+ *
+ * Implements    : FLEXCAN_DRV_ReceiveZeroCopy_Activity
+ *END**************************************************************************/
+status_t FLEXCAN_DRV_ReceiveZeroCopy(
+    uint8_t instance,
+    uint8_t mb_idx)
+{
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    const CAN_Type * base = g_flexcanBase[instance];
+    const flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    /* Check if the MB index is in range */
+    if (FLEXCAN_IsOutOfRangeMbIdx(base, mb_idx))
+    {
+        return STATUS_CAN_BUFF_OUT_OF_RANGE;
+    }
+    if (state->rxViewCallback == NULL)
+    {
+        return STATUS_ERROR;
+    }
+
+    return FLEXCAN_StartRxMessageBufferData(instance, mb_idx, NULL, NULL, false);
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_ReadRxQueue
+ * Description   : This function copies up to count queued frames of a
+ * continuous-receive message buffer, oldest first, and frees their slots.
+ *
+ * Implements    : FLEXCAN_DRV_ReadRxQueue_Activity
+ *END**************************************************************************/
+uint32_t FLEXCAN_DRV_ReadRxQueue(
+    uint8_t instance,
+    uint8_t mb_idx,
+    flexcan_msgbuff_t *data,
+    uint32_t count)
+{
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(mb_idx < FEATURE_CAN_MAX_MB_NUM);
+    DEV_ASSERT(data != NULL);
+
+    const flexcan_state_t * state = g_flexcanStatePtr[instance];
+    flexcan_rx_queue_t * queue = state->mbs[mb_idx].rxQueue;
+    uint16_t tail;
+    uint32_t available;
+    uint32_t i;
+
+    if (queue == NULL)
+    {
+        return 0U;
+    }
+
+    tail = queue->tail;
+    available = (uint16_t)(queue->head - tail);
+    if (count > available)
+    {
+        count = available;
+    }
+    /* Frame data written before head moved */
+    FLEXCAN_QUEUE_BARRIER();
+    for (i = 0U; i < count; i++)
+    {
+        data[i] = queue->frames[(uint16_t)(tail + i) & (queue->size - 1U)];
+    }
+    /* Slots copied out before they are handed back */
+    FLEXCAN_QUEUE_BARRIER();
+    queue->tail = (uint16_t)(tail + count);
+
+    return count;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_RxFifoBlocking
+ * Description   : This function receives a CAN frame using the Rx FIFO. The
+ * function blocks until either a frame was received, or the specified timeout
+ * expired.
+ *
+ * Implements    : FLEXCAN_DRV_RxFifoBlocking_Activity
+ *END**************************************************************************/
+status_t FLEXCAN_DRV_RxFifoBlocking(
+    uint8_t instance,
+    flexcan_msgbuff_t *data,
+    uint32_t timeout_ms)
+{
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+
+    status_t result;
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+    CAN_Type * base = g_flexcanBase[instance];
+
+    result = FLEXCAN_StartRxMessageFifoData(instance, data, true);
+
+    if (result == STATUS_SUCCESS)
+    {
+        result = OSIF_SemaWait(&state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].mbSema, timeout_ms);
+
+        if (state->transferType == FLEXCAN_RXFIFO_USING_INTERRUPTS)
+        {
+            /* Disable RX FIFO interrupts*/
+            (void)FLEXCAN_SetMsgBuffIntCmd(base, FEATURE_CAN_RXFIFO_FRAME_AVAILABLE, false);
+            (void)FLEXCAN_SetMsgBuffIntCmd(base, FEATURE_CAN_RXFIFO_WARNING, false);
+            (void)FLEXCAN_SetMsgBuffIntCmd(base, FEATURE_CAN_RXFIFO_OVERFLOW, false);
+        }
+#if FEATURE_CAN_HAS_DMA_ENABLE
+        else
+        {
+            /* This function always return status success */
+            (void)EDMA_DRV_StopChannel(state->rxFifoDMAChannel);
+        }
+#endif
+
+        if (result == STATUS_TIMEOUT)
+        {
+             /* If the status is updated reception successful else report TimeOut */
+            if (state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].state == FLEXCAN_MB_IDLE)
+            {
+                result = STATUS_SUCCESS;
                 /* add dummy wait for reset state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].mbSema at beginning of block functions */
                 (void) OSIF_SemaWait(&state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].mbSema, 0);
             }
@@ -1368,6 +1883,177 @@ status_t FLEXCAN_DRV_RxFifo(
     return result;
 }
 
+#if FEATURE_CAN_HAS_DMA_ENABLE
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_RxFifoContinuous
+ * Description   : This function starts streaming the Rx FIFO into a ring
+ * buffer with eDMA. The channel keeps running until the transfer is aborted;
+ * frames are taken out with FLEXCAN_DRV_ReadRxFifoRing.
+ *
+ * Implements    : FLEXCAN_DRV_RxFifoContinuous_Activity
+ *END**************************************************************************/
+status_t FLEXCAN_DRV_RxFifoContinuous(
+    uint8_t instance,
+    flexcan_rx_fifo_ring_t *ring,
+    flexcan_msgbuff_t *frames,
+    uint16_t size)
+{
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(ring != NULL);
+    DEV_ASSERT(frames != NULL);
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+    status_t result;
+
+    if (state->transferType != FLEXCAN_RXFIFO_USING_DMA)
+    {
+        return STATUS_ERROR;
+    }
+    /* Power of two: the half mark is exact and free-running indices wrap with a mask.
+     * The upper bound keeps the major loop count in range. */
+    if ((size < 2U) || ((size & (size - 1U)) != 0U) || (size > 0x4000U))
+    {
+        return STATUS_ERROR;
+    }
+    /* Do not pull the ring from under a running stream */
+    if (state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].state == FLEXCAN_MB_RX_BUSY)
+    {
+        return STATUS_BUSY;
+    }
+
+    ring->frames = frames;
+    ring->size = size;
+    ring->produced = 0U;
+    ring->consumed = 0U;
+    ring->overruns = 0U;
+    state->rxFifoRing = ring;
+
+    result = FLEXCAN_StartRxMessageFifoData(instance, NULL, false);
+    if (result != STATUS_SUCCESS)
+    {
+        state->rxFifoRing = NULL;
+    }
+
+    return result;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_RxFifoRingWritten
+ * Description   : Free-running number of frames the eDMA has written into the
+ * ring, from the current major loop count of the channel.
+ *
+ *END**************************************************************************/
+static uint32_t FLEXCAN_RxFifoRingWritten(const flexcan_state_t * state, const flexcan_rx_fifo_ring_t * ring)
+{
+    uint32_t mask = (uint32_t)ring->size - 1U;
+    uint32_t produced;
+    uint32_t position;
+
+    /* produced moves in the DMA interrupt; if it did while the position was
+     * read, the two do not match and are read again */
+    do
+    {
+        produced = ring->produced;
+        position = ((uint32_t)ring->size -
+                    EDMA_DRV_GetRemainingMajorIterationsCount(state->rxFifoDMAChannel)) & mask;
+    }
+    while (produced != ring->produced);
+
+    return produced + ((position - produced) & mask);
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_ReadRxFifoRing
+ * Description   : This function copies up to count frames of the Rx FIFO ring,
+ * oldest first, converting them like a single Rx FIFO reception does. The write
+ * position comes from the current major loop count of the channel, so frames
+ * are available before the next half/full notification. The position is read
+ * again after the copy: entries the eDMA reached meanwhile may be torn and are
+ * dropped as overruns.
+ *
+ * Implements    : FLEXCAN_DRV_ReadRxFifoRing_Activity
+ *END**************************************************************************/
+uint32_t FLEXCAN_DRV_ReadRxFifoRing(
+    uint8_t instance,
+    flexcan_msgbuff_t *data,
+    uint32_t count)
+{
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(data != NULL);
+
+    const flexcan_state_t * state = g_flexcanStatePtr[instance];
+    flexcan_rx_fifo_ring_t * ring = state->rxFifoRing;
+    uint32_t mask;
+    uint32_t written;
+    uint32_t consumed;
+    uint32_t reached;
+    uint32_t torn;
+    uint32_t i;
+
+    if (ring == NULL)
+    {
+        return 0U;
+    }
+
+    mask = (uint32_t)ring->size - 1U;
+    written = FLEXCAN_RxFifoRingWritten(state, ring);
+
+    consumed = ring->consumed;
+    if ((written - consumed) >= (uint32_t)ring->size)
+    {
+        /* Lapped: the oldest entry is being overwritten; resume half a ring behind the writer */
+        uint32_t resume = written - ((uint32_t)ring->size >> 1U);
+
+        ring->overruns += resume - consumed;
+        consumed = resume;
+    }
+    if (count > (written - consumed))
+    {
+        count = written - consumed;
+    }
+
+    /* Entries written by the DMA before the position moved */
+    FLEXCAN_QUEUE_BARRIER();
+    for (i = 0U; i < count; i++)
+    {
+        const flexcan_msgbuff_t *entry = &ring->frames[(consumed + i) & mask];
+        const uint32_t *entryData_32 = (const uint32_t *)entry->data;
+        uint32_t *msgData_32 = (uint32_t *)data[i].data;
+
+        /* Only the 16 bytes written by the DMA */
+        data[i].cs = entry->cs;
+        data[i].msgId = entry->msgId;
+        msgData_32[0] = entryData_32[0];
+        msgData_32[1] = entryData_32[1];
+    }
+
+    /* Entry n is rewritten with frame n + size once the writer gets there;
+     * the copies of the entries before 'reached' cannot be trusted */
+    FLEXCAN_QUEUE_BARRIER();
+    reached = FLEXCAN_RxFifoRingWritten(state, ring) - (uint32_t)ring->size + 1U;
+    torn = ((int32_t)(reached - consumed) > 0) ? (reached - consumed) : 0U;
+    if (torn > count)
+    {
+        torn = count;
+    }
+    ring->overruns += torn;
+    ring->consumed = consumed + count;
+
+    for (i = torn; i < count; i++)
+    {
+        if (torn != 0U)
+        {
+            data[i - torn] = data[i];
+        }
+        FLEXCAN_FixupRxFifoFrame(&data[i - torn]);
+    }
+
+    return count - torn;
+}
+#endif /* FEATURE_CAN_HAS_DMA_ENABLE */
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_DRV_Deinit
@@ -1598,28 +2284,17 @@ static inline void FLEXCAN_IRQHandlerRxFIFO(uint8_t instance, uint32_t mb_idx)
 
 /*FUNCTION**********************************************************************
  *
- * Function Name : FLEXCAN_IRQHandlerRxMB
- * Description   : Process IRQHandler in case of Rx MessageBuffer selection
- * for CAN interface.
+ * Function Name : FLEXCAN_ReleaseRxMsgBuff
+ * Description   : Clear the flag of a locked Rx message buffer whose CS word
+ * was read as cs, and unlock it.
  *
- * This is not a public API as it is called whenever an interrupt and receive
- * individual MB occurs
  *END**************************************************************************/
-static void FLEXCAN_IRQHandlerRxMB(uint8_t instance, uint32_t mb_idx)
+static void FLEXCAN_ReleaseRxMsgBuff(CAN_Type * base, uint32_t mb_idx, uint32_t cs)
 {
-     CAN_Type * base = g_flexcanBase[instance];
-     flexcan_state_t * state = g_flexcanStatePtr[instance];
-
-     /* Lock RX message buffer and RX FIFO*/
-     FLEXCAN_LockRxMsgBuff(base, mb_idx);
-
-     /* Get RX MB field values*/
-     FLEXCAN_GetMsgBuff(base, mb_idx, state->mbs[mb_idx].mb_message);
-
     /* Clear the proper flag in the IFLAG register */
     FLEXCAN_ClearMsgBuffIntStatusFlag(base, mb_idx);
     /* the CODE field is updated with an incorrect value when MBx is locked by software for more than 20 CAN bit times and FIFO enable */
-    if ((FLEXCAN_IsRxFifoEnabled(base)) && (((state->mbs[mb_idx].mb_message->cs & CAN_CS_CODE_MASK) >> CAN_CS_CODE_SHIFT) == (uint32_t)FLEXCAN_RX_INACTIVE))
+    if ((FLEXCAN_IsRxFifoEnabled(base)) && (((cs & CAN_CS_CODE_MASK) >> CAN_CS_CODE_SHIFT) == (uint32_t)FLEXCAN_RX_INACTIVE))
     {
         /* Update the cs code for next sequence move in MB.
         A CPU write into the C/S word also unlocks the MB */
@@ -1632,6 +2307,91 @@ static void FLEXCAN_IRQHandlerRxMB(uint8_t instance, uint32_t mb_idx)
         /* Unlock RX message buffer and RX FIFO*/
         FLEXCAN_UnlockRxMsgBuff(base);
     }
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_IRQHandlerRxView
+ * Description   : Process IRQHandler in case of a zero-copy Rx MessageBuffer.
+ * The callback reads the frame from the locked MB; the MB is released and
+ * stays armed when it returns.
+ *
+ * This is not a public API as it is called whenever an interrupt and receive
+ * individual MB occurs
+ *END**************************************************************************/
+static void FLEXCAN_IRQHandlerRxView(uint8_t instance, uint32_t mb_idx)
+{
+    CAN_Type * base = g_flexcanBase[instance];
+    const flexcan_state_t * state = g_flexcanStatePtr[instance];
+    flexcan_mb_view_t view;
+
+    /* Lock RX message buffer and RX FIFO*/
+    FLEXCAN_LockRxMsgBuff(base, mb_idx);
+
+    FLEXCAN_GetMsgBuffView(base, mb_idx, &view);
+    if (state->rxViewCallback != NULL)
+    {
+        state->rxViewCallback(instance, mb_idx, &view, state->rxViewCallbackParam);
+    }
+
+    FLEXCAN_ReleaseRxMsgBuff(base, mb_idx, view.cs);
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_IRQHandlerRxMB
+ * Description   : Process IRQHandler in case of Rx MessageBuffer selection
+ * for CAN interface.
+ *
+ * This is not a public API as it is called whenever an interrupt and receive
+ * individual MB occurs
+ *END**************************************************************************/
+static void FLEXCAN_IRQHandlerRxMB(uint8_t instance, uint32_t mb_idx)
+{
+     CAN_Type * base = g_flexcanBase[instance];
+     flexcan_state_t * state = g_flexcanStatePtr[instance];
+     flexcan_rx_queue_t * queue = state->mbs[mb_idx].rxQueue;
+     flexcan_msgbuff_t * frame = state->mbs[mb_idx].mb_message;
+
+     if (state->mbs[mb_idx].isZeroCopy)
+     {
+         FLEXCAN_IRQHandlerRxView(instance, mb_idx);
+         return;
+     }
+
+     if (queue != NULL)
+     {
+         if ((uint16_t)(queue->head - queue->tail) >= queue->size)
+         {
+             /* Queue full: drop the frame, the MB stays armed */
+             FLEXCAN_ClearMsgBuffIntStatusFlag(base, mb_idx);
+             queue->overflows++;
+             return;
+         }
+         frame = &queue->frames[queue->head & (queue->size - 1U)];
+     }
+
+     /* Lock RX message buffer and RX FIFO*/
+     FLEXCAN_LockRxMsgBuff(base, mb_idx);
+
+     /* Get RX MB field values*/
+     FLEXCAN_GetMsgBuff(base, mb_idx, frame);
+
+     FLEXCAN_ReleaseRxMsgBuff(base, mb_idx, frame->cs);
+
+     if (queue != NULL)
+     {
+         /* Publish the frame; the MB stays armed for the next one */
+         FLEXCAN_QUEUE_BARRIER();
+         queue->head++;
+         queue->received++;
+
+         if (state->callback != NULL)
+         {
+             state->callback(instance, FLEXCAN_EVENT_RX_COMPLETE, mb_idx, state);
+         }
+         return;
+     }
 
      state->mbs[mb_idx].state = FLEXCAN_MB_IDLE;
 
@@ -1674,6 +2434,81 @@ void FLEXCAN_BusOff_IRQHandler(uint8_t instance)
     FLEXCAN_ClearBusOffIntStatusFlag(base);
 }
 
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_LowestSetBit
+ * Description   : Index of the lowest set bit of a non-zero word (count
+ * trailing zeros, RBIT + CLZ on Cortex-M).
+ *
+ *END**************************************************************************/
+static inline uint32_t FLEXCAN_LowestSetBit(uint32_t value)
+{
+#if defined(__GNUC__)
+    return (uint32_t)__builtin_ctz(value);
+#else
+    uint32_t idx = 0U;
+
+    while ((value & 1U) == 0U)
+    {
+        value >>= 1U;
+        idx++;
+    }
+    return idx;
+#endif
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_IRQHandlerTxMB
+ * Description   : Process IRQHandler in case of a completed transmission.
+ * The flag of a data frame has already been cleared by the caller.
+ *
+ * This is not a public API as it is called whenever an interrupt and transmit
+ * individual MB occurs
+ *END**************************************************************************/
+static void FLEXCAN_IRQHandlerTxMB(uint8_t instance, uint32_t mb_idx)
+{
+    CAN_Type * base = g_flexcanBase[instance];
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    if (state->mbs[mb_idx].isRemote)
+    {
+        /* If the frame was a remote frame, clear the flag only if the response was
+         * not received yet. If the response was received, leave the flag set in order
+         * to be handled when the user calls FLEXCAN_DRV_RxMessageBuffer. */
+        flexcan_msgbuff_t mb;
+        FLEXCAN_LockRxMsgBuff(base, mb_idx);
+        FLEXCAN_GetMsgBuff(base, mb_idx, &mb);
+        FLEXCAN_UnlockRxMsgBuff(base);
+
+        if (((mb.cs & CAN_CS_CODE_MASK) >> CAN_CS_CODE_SHIFT) == (uint32_t)FLEXCAN_RX_EMPTY)
+        {
+            FLEXCAN_ClearMsgBuffIntStatusFlag(base, mb_idx);
+        }
+    }
+
+    state->mbs[mb_idx].state = FLEXCAN_MB_IDLE;
+
+    /* Invoke callback */
+    if (state->callback != NULL)
+    {
+        state->callback(instance, FLEXCAN_EVENT_TX_COMPLETE, mb_idx, state);
+    }
+
+    if (state->mbs[mb_idx].state == FLEXCAN_MB_IDLE)
+    {
+        /* Complete transmit data */
+        FLEXCAN_CompleteTransfer(instance, mb_idx);
+
+        /* Feed the free MB from the transmit queue */
+        if ((state->txQueue != NULL) && (mb_idx < 32U) &&
+            ((state->txQueue->mbMask & ((uint32_t)1U << mb_idx)) != 0U))
+        {
+            FLEXCAN_TxQueueRefill(instance);
+        }
+    }
+}
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_IRQHandler
@@ -1681,108 +2516,131 @@ void FLEXCAN_BusOff_IRQHandler(uint8_t instance)
  * This handler read data from MB or FIFO, and then clear the interrupt flags.
  * This is not a public API as it is called whenever an interrupt occurs.
  *
+ * Each flag register is read once (IFLAGn & IMASKn) and every set bit is
+ * serviced in the same entry, lowest mailbox first. Flags that need no
+ * frame access (completed data transmissions, mailboxes nobody waits on)
+ * are cleared with a single write before any callback runs, so a callback
+ * that reuses its mailbox never loses the new flag.
+ *
  *END**************************************************************************/
 void FLEXCAN_IRQHandler(uint8_t instance)
 {
     DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
 
-    uint32_t flag_reg = 0;
     CAN_Type * base = g_flexcanBase[instance];
     flexcan_state_t * state = g_flexcanStatePtr[instance];
+    bool fifoEnabled = FLEXCAN_IsRxFifoEnabled(base);
+    bool serviced = false;
+    uint32_t word;
 
-    /* Get the interrupts that are enabled and ready */
-    uint32_t mb_idx = 0;
-    flag_reg = FLEXCAN_GetMsgBuffIntStatusFlag(base, mb_idx);
-
-    while ((flag_reg & 1U) == 0U)
+    for (word = 0U; word < FLEXCAN_MB_FLAG_WORDS; word++)
     {
-        mb_idx++;
-        flag_reg = FLEXCAN_GetMsgBuffIntStatusFlag(base, mb_idx);
+        /* Get the interrupts that are enabled and ready */
+        uint32_t pending = FLEXCAN_GetMsgBuffIntStatusWord(base, word);
+        uint32_t early = 0U;
+        uint32_t stale = 0U;
+        uint32_t late = 0U;
+        uint32_t bits;
 
-        if (mb_idx >= FEATURE_CAN_MAX_MB_NUM)
+        if (pending == 0U)
         {
-            break;
+            continue;
         }
-    }
+        serviced = true;
 
-    /* Check Tx/Rx interrupt flag and clear the interrupt */
-    if(flag_reg != 0U)
-    {
-        if (FLEXCAN_IsRxFifoEnabled(base) && (mb_idx <= FEATURE_CAN_RXFIFO_OVERFLOW))
-        {
-            FLEXCAN_IRQHandlerRxFIFO(instance, mb_idx);
-        }
-        else
+        /* Pass 1: flags that can be cleared up front */
+        bits = pending;
+        while (bits != 0U)
         {
-            /* Check mailbox completed reception */
-            if (state->mbs[mb_idx].state == FLEXCAN_MB_RX_BUSY)
+            uint32_t bit = FLEXCAN_LowestSetBit(bits);
+            uint32_t mb_idx = (word * 32U) + bit;
+
+            bits &= bits - 1U;
+            if (fifoEnabled && (mb_idx <= FEATURE_CAN_RXFIFO_OVERFLOW))
             {
-                FLEXCAN_IRQHandlerRxMB(instance, mb_idx);
+                continue;
             }
+            if (state->mbs[mb_idx].state == FLEXCAN_MB_IDLE)
+            {
+                /* In case of desynchronized status of the MB to avoid trapping in ISR
+                 * clear the MB flag */
+                stale |= (uint32_t)1U << bit;
+            }
+            else if ((state->mbs[mb_idx].state == FLEXCAN_MB_TX_BUSY) && (!state->mbs[mb_idx].isRemote))
+            {
+                early |= (uint32_t)1U << bit;
+            }
+            else
+            {
+                /* Serviced below */
+            }
+        }
+        if ((early | stale) != 0U)
+        {
+            FLEXCAN_ClearMsgBuffIntStatusWord(base, word, early | stale);
         }
 
-        /* Check mailbox completed transmission */
-        if (state->mbs[mb_idx].state == FLEXCAN_MB_TX_BUSY)
+        /* Pass 2: service the ready mailboxes */
+        bits = pending & ~stale;
+        while (bits != 0U)
         {
-            if (state->mbs[mb_idx].isRemote)
+            uint32_t mb_idx = (word * 32U) + FLEXCAN_LowestSetBit(bits);
+
+            bits &= bits - 1U;
+            if (fifoEnabled && (mb_idx <= FEATURE_CAN_RXFIFO_OVERFLOW))
             {
-                /* If the frame was a remote frame, clear the flag only if the response was
-                 * not received yet. If the response was received, leave the flag set in order
-                 * to be handled when the user calls FLEXCAN_DRV_RxMessageBuffer. */
-                flexcan_msgbuff_t mb;
-                FLEXCAN_LockRxMsgBuff(base, mb_idx);
-                FLEXCAN_GetMsgBuff(base, mb_idx, &mb);
-                FLEXCAN_UnlockRxMsgBuff(base);
-
-                if (((mb.cs & CAN_CS_CODE_MASK) >> CAN_CS_CODE_SHIFT) == (uint32_t)FLEXCAN_RX_EMPTY)
+                uint32_t frames = 0U;
+
+                /* Drain the FIFO while the receiver keeps re-arming it */
+                do
                 {
-                    FLEXCAN_ClearMsgBuffIntStatusFlag(base, mb_idx);
-                }
+                    FLEXCAN_IRQHandlerRxFIFO(instance, mb_idx);
+                    frames++;
+                } while ((mb_idx == FEATURE_CAN_RXFIFO_FRAME_AVAILABLE) &&
+                         (frames < FLEXCAN_RXFIFO_DEPTH) &&
+                         (state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].state == FLEXCAN_MB_RX_BUSY) &&
+                         (FLEXCAN_GetMsgBuffIntStatusFlag(base, mb_idx) != 0U));
             }
-            else
+            else if (state->mbs[mb_idx].state == FLEXCAN_MB_RX_BUSY)
             {
-                FLEXCAN_ClearMsgBuffIntStatusFlag(base, mb_idx);
+                /* Check mailbox completed reception */
+                FLEXCAN_IRQHandlerRxMB(instance, mb_idx);
             }
-
-            state->mbs[mb_idx].state = FLEXCAN_MB_IDLE;
-
-            /* Invoke callback */
-            if (state->callback != NULL)
+            else if (state->mbs[mb_idx].state == FLEXCAN_MB_TX_BUSY)
             {
-                state->callback(instance, FLEXCAN_EVENT_TX_COMPLETE, mb_idx, state);
+                /* Check mailbox completed transmission */
+                FLEXCAN_IRQHandlerTxMB(instance, mb_idx);
             }
-
-            if (state->mbs[mb_idx].state == FLEXCAN_MB_IDLE)
+            else
             {
-                /* Complete transmit data */
-                FLEXCAN_CompleteTransfer(instance, mb_idx);
+                /* Do Nothing */
             }
         }
 
-        if (FLEXCAN_GetMsgBuffIntStatusFlag(base, mb_idx) != 0U)
+        /* Pass 3: flags set again on mailboxes left idle by their callbacks */
+        bits = FLEXCAN_GetMsgBuffIntStatusWord(base, word) & pending & ~stale;
+        while (bits != 0U)
         {
-            if (FLEXCAN_IsRxFifoEnabled(base) && (mb_idx <= FEATURE_CAN_RXFIFO_OVERFLOW))
+            uint32_t bit = FLEXCAN_LowestSetBit(bits);
+            uint32_t mb_idx = (word * 32U) + bit;
+
+            bits &= bits - 1U;
+            if (fifoEnabled && (mb_idx <= FEATURE_CAN_RXFIFO_OVERFLOW))
             {
-                if (state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].state == FLEXCAN_MB_IDLE)
-                {
-                /* In case of desynchronized status of the MB to avoid trapping in ISR
-                 * clear the MB flag */
-                FLEXCAN_ClearMsgBuffIntStatusFlag(base, mb_idx);
-                }
+                mb_idx = FLEXCAN_MB_HANDLE_RXFIFO;
             }
-            else
+            if (state->mbs[mb_idx].state == FLEXCAN_MB_IDLE)
             {
-                if (state->mbs[mb_idx].state == FLEXCAN_MB_IDLE)
-                {
-                    /* In case of desynchronized status of the MB to avoid trapping in ISR
-                     * clear the MB flag */
-                    FLEXCAN_ClearMsgBuffIntStatusFlag(base, mb_idx);
-                }
+                late |= (uint32_t)1U << bit;
             }
         }
+        if (late != 0U)
+        {
+            FLEXCAN_ClearMsgBuffIntStatusWord(base, word, late);
+        }
     }
 #if (defined(CPU_S32K116) || defined(CPU_S32K118))
-    else
+    if (!serviced)
     {
 #if FEATURE_CAN_HAS_PRETENDED_NETWORKING
         /* The pretending Network Feature is present on all CPUs
@@ -1808,6 +2666,8 @@ void FLEXCAN_IRQHandler(uint8_t instance)
             FLEXCAN_Error_IRQHandler(instance);
         }
     }
+#else
+    (void)serviced;
 #endif /* (defined(CPU_S32K116) || defined(CPU_S32K118)) */
     return;
 }
@@ -2139,6 +2999,7 @@ static status_t FLEXCAN_StartRxMessageBufferData(
                     uint8_t instance,
                     uint8_t mb_idx,
                     flexcan_msgbuff_t *data,
+                    flexcan_rx_queue_t *queue,
                     bool isBlocking
                     )
 {
@@ -2180,6 +3041,16 @@ static status_t FLEXCAN_StartRxMessageBufferData(
     state->mbs[mb_idx].state = FLEXCAN_MB_RX_BUSY;
     state->mbs[mb_idx].mb_message = data;
     state->mbs[mb_idx].isBlocking = isBlocking;
+    if (queue != NULL)
+    {
+        queue->head = 0U;
+        queue->tail = 0U;
+        queue->received = 0U;
+        queue->overflows = 0U;
+    }
+    state->mbs[mb_idx].rxQueue = queue;
+    /* Neither a buffer nor a queue: frames are handed out in place */
+    state->mbs[mb_idx].isZeroCopy = (data == NULL) && (queue == NULL);
 
     /* Enable MB interrupt*/
     result = FLEXCAN_SetMsgBuffIntCmd(base, mb_idx, true);
@@ -2271,30 +3142,46 @@ static status_t FLEXCAN_StartRxMessageFifoData(
     {
         status_t edmaStatus;
 
-        edmaStatus = EDMA_DRV_InstallCallback(state->rxFifoDMAChannel,
-                                              FLEXCAN_CompleteRxFifoDataDMA,
-                                              (void *)((uint32_t)instance));
-
-        if (edmaStatus != STATUS_SUCCESS)
+        if (data == NULL)
         {
-            state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].state = FLEXCAN_MB_IDLE;
-            return STATUS_ERROR;
+            /* No frame buffer: stream into the ring set up by FLEXCAN_DRV_RxFifoContinuous */
+            edmaStatus = FLEXCAN_ConfigRxFifoRingDMA(instance);
+            if (edmaStatus != STATUS_SUCCESS)
+            {
+                state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].state = FLEXCAN_MB_IDLE;
+                return STATUS_ERROR;
+            }
         }
+        else
+        {
+            /* The channel no longer tracks the ring, it cannot be read any more */
+            state->rxFifoRing = NULL;
 
-        edmaStatus = EDMA_DRV_ConfigSingleBlockTransfer(state->rxFifoDMAChannel,
-                                                        EDMA_TRANSFER_MEM2MEM,
-                                                        (uint32_t)(base->RAMn),
-                                                        (uint32_t)(state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].mb_message),
-                                                        EDMA_TRANSFER_SIZE_4B,
-                                                        16U);
+            edmaStatus = EDMA_DRV_InstallCallback(state->rxFifoDMAChannel,
+                                                  FLEXCAN_CompleteRxFifoDataDMA,
+                                                  (void *)((uint32_t)instance));
 
-        if (edmaStatus != STATUS_SUCCESS)
-        {
-            state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].state = FLEXCAN_MB_IDLE;
-            return STATUS_ERROR;
-        }
+            if (edmaStatus != STATUS_SUCCESS)
+            {
+                state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].state = FLEXCAN_MB_IDLE;
+                return STATUS_ERROR;
+            }
 
-        EDMA_DRV_DisableRequestsOnTransferComplete(state->rxFifoDMAChannel, true);
+            edmaStatus = EDMA_DRV_ConfigSingleBlockTransfer(state->rxFifoDMAChannel,
+                                                            EDMA_TRANSFER_MEM2MEM,
+                                                            (uint32_t)(base->RAMn),
+                                                            (uint32_t)(state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].mb_message),
+                                                            EDMA_TRANSFER_SIZE_4B,
+                                                            FLEXCAN_RXFIFO_FRAME_BYTES);
+
+            if (edmaStatus != STATUS_SUCCESS)
+            {
+                state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].state = FLEXCAN_MB_IDLE;
+                return STATUS_ERROR;
+            }
+
+            EDMA_DRV_DisableRequestsOnTransferComplete(state->rxFifoDMAChannel, true);
+        }
 
         edmaStat = EDMA_DRV_StartChannel(state->rxFifoDMAChannel);
         if (edmaStat != STATUS_SUCCESS)
@@ -2362,6 +3249,138 @@ static void FLEXCAN_CompleteRxFifoDataDMA(void *parameter, edma_chn_status_t sta
     }
     FLEXCAN_CompleteRxMessageFifoData((uint8_t)instance);
 }
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_ConfigRxFifoRingDMA
+ * Description   : Programs the Rx FIFO DMA channel to stream into the ring.
+ * Each FIFO request moves the 16 bytes of the output window (kept in place by
+ * a 16 byte source modulo) into the next ring entry; the destination skips the
+ * rest of the entry with the minor loop offset and goes back to the first one
+ * at the end of the major loop. The channel never disables its request, and
+ * interrupts at the half and full marks.
+ * This is not a public API as it is called from other driver functions.
+ *
+ *END**************************************************************************/
+static status_t FLEXCAN_ConfigRxFifoRingDMA(uint8_t instance)
+{
+    const CAN_Type * base = g_flexcanBase[instance];
+    const flexcan_state_t * state = g_flexcanStatePtr[instance];
+    const flexcan_rx_fifo_ring_t * ring = state->rxFifoRing;
+    edma_loop_transfer_config_t loopConfig;
+    edma_transfer_config_t transferConfig;
+    status_t edmaStatus;
+
+    DEV_ASSERT(ring != NULL);
+
+    loopConfig.majorLoopIterationCount = ring->size;
+    loopConfig.srcOffsetEnable = false;
+    loopConfig.dstOffsetEnable = true;
+    loopConfig.minorLoopOffset = (int32_t)(sizeof(flexcan_msgbuff_t) - FLEXCAN_RXFIFO_FRAME_BYTES);
+    loopConfig.minorLoopChnLinkEnable = false;
+    loopConfig.minorLoopChnLinkNumber = 0U;
+    loopConfig.majorLoopChnLinkEnable = false;
+    loopConfig.majorLoopChnLinkNumber = 0U;
+
+    transferConfig.srcAddr = (uint32_t)(base->RAMn);
+    transferConfig.destAddr = (uint32_t)(ring->frames);
+    transferConfig.srcTransferSize = EDMA_TRANSFER_SIZE_4B;
+    transferConfig.destTransferSize = EDMA_TRANSFER_SIZE_4B;
+    transferConfig.srcOffset = 4;
+    transferConfig.destOffset = 4;
+    transferConfig.srcLastAddrAdjust = 0;
+    /* The last minor loop takes DLAST instead of the minor loop offset: DADDR
+     * ends right after the 16 bytes of the last entry */
+    transferConfig.destLastAddrAdjust = -(int32_t)((((uint32_t)ring->size - 1U) * sizeof(flexcan_msgbuff_t)) +
+                                                   FLEXCAN_RXFIFO_FRAME_BYTES);
+    transferConfig.srcModulo = EDMA_MODULO_16B;
+    transferConfig.destModulo = EDMA_MODULO_OFF;
+    transferConfig.minorByteTransferCount = FLEXCAN_RXFIFO_FRAME_BYTES;
+    transferConfig.scatterGatherEnable = false;
+    transferConfig.scatterGatherNextDescAddr = 0U;
+    transferConfig.interruptEnable = true;
+    transferConfig.loopTransferConfig = &loopConfig;
+
+    edmaStatus = EDMA_DRV_InstallCallback(state->rxFifoDMAChannel,
+                                          FLEXCAN_RxFifoRingDMA,
+                                          (void *)((uint32_t)instance));
+    if (edmaStatus == STATUS_SUCCESS)
+    {
+        edmaStatus = EDMA_DRV_ConfigLoopTransfer(state->rxFifoDMAChannel, &transferConfig);
+    }
+    if (edmaStatus == STATUS_SUCCESS)
+    {
+        EDMA_DRV_ConfigureInterrupt(state->rxFifoDMAChannel, EDMA_CHN_HALF_MAJOR_LOOP_INT, true);
+        EDMA_DRV_DisableRequestsOnTransferComplete(state->rxFifoDMAChannel, false);
+    }
+
+    return edmaStatus;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_RxFifoRingDMA
+ * Description   : DMA callback of the Rx FIFO ring. The half and major loop
+ * interrupts alternate, each one accounts for half a ring of new frames.
+ * This is not a public API as it is called from other driver functions.
+ *
+ *END**************************************************************************/
+static void FLEXCAN_RxFifoRingDMA(void *parameter, edma_chn_status_t status)
+{
+    uint32_t instance = (uint32_t)parameter;
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+    flexcan_rx_fifo_ring_t * ring = state->rxFifoRing;
+    flexcan_event_type_t event;
+
+    if (status == EDMA_CHN_ERROR)
+    {
+        /* The channel request is already disabled, FLEXCAN_DRV_RxFifoContinuous recovers */
+        state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].state = FLEXCAN_MB_DMA_ERROR;
+        event = FLEXCAN_EVENT_DMA_ERROR;
+    }
+    else if (ring != NULL)
+    {
+        ring->produced += (uint32_t)ring->size >> 1U;
+        event = ((ring->produced & ((uint32_t)ring->size - 1U)) == 0U) ?
+                FLEXCAN_EVENT_RXFIFO_RING_FULL : FLEXCAN_EVENT_RXFIFO_RING_HALF;
+    }
+    else
+    {
+        return;
+    }
+
+    if (state->callback != NULL)
+    {
+        state->callback((uint8_t)instance,
+                        event,
+                        FLEXCAN_MB_HANDLE_RXFIFO,
+                        state);
+    }
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_FixupRxFifoFrame
+ * Description   : Converts a frame copied raw from the Rx FIFO output: shifts
+ * a standard ID down, extracts the data length and restores the byte order.
+ * This is not a public API as it is called from other driver functions.
+ *
+ *END**************************************************************************/
+static inline void FLEXCAN_FixupRxFifoFrame(flexcan_msgbuff_t *frame)
+{
+    uint32_t *msgData_32 = (uint32_t *)frame->data;
+
+    /* Adjust the ID if it is not extended */
+    if (((frame->cs) & CAN_CS_IDE_MASK) == 0U)
+    {
+        frame->msgId = frame->msgId >> CAN_ID_STD_SHIFT;
+    }
+    /* Extract the data length */
+    frame->dataLen = (uint8_t)((frame->cs & CAN_CS_DLC_MASK) >> CAN_CS_DLC_SHIFT);
+    /* Reverse the endianness */
+    FlexcanSwapBytesInWord(msgData_32[0], msgData_32[0]);
+    FlexcanSwapBytesInWord(msgData_32[1], msgData_32[1]);
+}
 #endif
 
 /*FUNCTION**********************************************************************
@@ -2391,20 +3410,8 @@ static void FLEXCAN_CompleteRxMessageFifoData(uint8_t instance)
     {
         if (state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].state != FLEXCAN_MB_DMA_ERROR)
         {
-            flexcan_msgbuff_t *fifo_message = state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].mb_message;
-            uint32_t *msgData_32 = (uint32_t *)fifo_message->data;
-
             (void) EDMA_DRV_StopChannel(state->rxFifoDMAChannel);
-            /* Adjust the ID if it is not extended */
-            if (((fifo_message->cs) & CAN_CS_IDE_MASK) == 0U)
-            {
-                fifo_message->msgId = fifo_message->msgId >> CAN_ID_STD_SHIFT;
-            }
-            /* Extract the data length */
-            fifo_message->dataLen = (uint8_t)((fifo_message->cs & CAN_CS_DLC_MASK) >> CAN_CS_DLC_SHIFT);
-            /* Reverse the endianness */
-            FlexcanSwapBytesInWord(msgData_32[0], msgData_32[0]);
-            FlexcanSwapBytesInWord(msgData_32[1], msgData_32[1]);
+            FLEXCAN_FixupRxFifoFrame(state->mbs[FLEXCAN_MB_HANDLE_RXFIFO].mb_message);
         }
     }
 #endif
@@ -2458,6 +3465,26 @@ void FLEXCAN_DRV_InstallEventCallback(uint8_t instance,
     state->callbackParam = callbackParam;
 }
 
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_InstallRxViewCallback
+ * Description   : Installs the callback for message buffers armed with
+ * FLEXCAN_DRV_ReceiveZeroCopy.
+ *
+ * Implements    : FLEXCAN_DRV_InstallRxViewCallback_Activity
+ *END**************************************************************************/
+void FLEXCAN_DRV_InstallRxViewCallback(uint8_t instance,
+                                       flexcan_rx_view_callback_t callback,
+                                       void *callbackParam)
+{
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    state->rxViewCallback = callback;
+    state->rxViewCallbackParam = callbackParam;
+}
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_DRV_InstallErrorCallback
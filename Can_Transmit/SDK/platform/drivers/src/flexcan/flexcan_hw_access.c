@@ -958,6 +958,39 @@ void FLEXCAN_GetMsgBuff(
     }
 }
 
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_GetMsgBuffView
+ * Description   : Get the header fields of a message buffer without copying
+ * the data field; the view points to the data in FlexCAN RAM.
+ *
+ *END**************************************************************************/
+void FLEXCAN_GetMsgBuffView(
+    CAN_Type * base,
+    uint32_t msgBuffIdx,
+    flexcan_mb_view_t *view)
+{
+    DEV_ASSERT(view != NULL);
+
+    volatile const uint32_t *flexcan_mb = FLEXCAN_GetMsgBuffRegion(base, msgBuffIdx);
+    uint32_t cs = flexcan_mb[0];
+    uint8_t payload_size = FLEXCAN_ComputePayloadSize((uint8_t)((cs & CAN_CS_DLC_MASK) >> CAN_CS_DLC_SHIFT));
+
+#if FEATURE_CAN_HAS_FD
+    if (payload_size > FLEXCAN_GetPayloadSize(base))
+    {
+        payload_size = FLEXCAN_GetPayloadSize(base);
+    }
+#endif /* FEATURE_CAN_HAS_FD */
+
+    view->cs = cs;
+    view->dataLen = payload_size;
+    view->timestamp = (uint16_t)((cs & CAN_CS_TIME_STAMP_MASK) >> CAN_CS_TIME_STAMP_SHIFT);
+    view->isExtended = ((cs & CAN_CS_IDE_MASK) != 0U);
+    view->msgId = view->isExtended ? flexcan_mb[1] : (flexcan_mb[1] >> CAN_ID_STD_SHIFT);
+    view->data = (volatile const uint8_t *)(&flexcan_mb[2]);
+}
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_LockRxMsgBuff
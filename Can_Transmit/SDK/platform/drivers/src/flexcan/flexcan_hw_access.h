@@ -300,6 +300,17 @@ static inline void FLEXCAN_SelectClock(CAN_Type * base, flexcan_clk_source_t clk
 }
 #endif
 
+/*!
+ * @brief Selects which pending Tx message buffer is sent first.
+ *
+ * @param   base        The FlexCAN base address
+ * @param   lowestMb    true: lowest numbered MB first; false: lowest CAN ID first
+ */
+static inline void FLEXCAN_SetLowestBufferFirst(CAN_Type * base, bool lowestMb)
+{
+    base->CTRL1 = (base->CTRL1 & ~CAN_CTRL1_LBUF_MASK) | CAN_CTRL1_LBUF(lowestMb ? 1UL : 0UL);
+}
+
 /*!
  * @brief Initializes the FlexCAN controller.
  *
@@ -633,6 +644,18 @@ void FLEXCAN_GetMsgBuff(
     uint32_t msgBuffIdx,
     flexcan_msgbuff_t *msgBuff);
 
+/*!
+ * @brief Gets the header fields of a message buffer and points to its payload.
+ *
+ * @param   base  The FlexCAN base address
+ * @param   msgBuffIdx       Index of the message buffer
+ * @param   view             The header fields and the payload address
+ */
+void FLEXCAN_GetMsgBuffView(
+    CAN_Type * base,
+    uint32_t msgBuffIdx,
+    flexcan_mb_view_t *view);
+
 /*!
  * @brief Locks the FlexCAN Rx message buffer.
  *
@@ -900,6 +923,64 @@ static inline void FLEXCAN_ClearMsgBuffIntStatusFlag(CAN_Type * base, uint32_t m
 #endif
 }
 
+/*!
+ * @brief Gets the enabled and set MB interrupt flags of 32 message buffers.
+ *
+ * @param   base  The FlexCAN base address
+ * @param   word  0 for MB 0-31 (IFLAG1), 1 for MB 32-63 (IFLAG2), 2 for MB 64-95 (IFLAG3)
+ * @return  IFLAGn & IMASKn, bit i = message buffer (32 * word + i)
+ */
+static inline uint32_t FLEXCAN_GetMsgBuffIntStatusWord(const CAN_Type * base, uint32_t word)
+{
+    uint32_t flags = 0U;
+
+    if (word == 0U)
+    {
+        flags = base->IFLAG1 & base->IMASK1 & CAN_IMASK1_BUF31TO0M_MASK;
+    }
+#if FEATURE_CAN_MAX_MB_NUM > 32U
+    if (word == 1U)
+    {
+        flags = base->IFLAG2 & base->IMASK2 & CAN_IMASK2_BUF63TO32M_MASK;
+    }
+#endif
+#if FEATURE_CAN_MAX_MB_NUM > 64U
+    if (word == 2U)
+    {
+        flags = base->IFLAG3 & base->IMASK3 & CAN_IMASK3_BUF95TO64M_MASK;
+    }
+#endif
+
+    return flags;
+}
+
+/*!
+ * @brief Clears the interrupt flags of several message buffers with one write.
+ *
+ * @param   base  The FlexCAN base address
+ * @param   word  Flag register, as for FLEXCAN_GetMsgBuffIntStatusWord
+ * @param   mask  Bit i clears the flag of message buffer (32 * word + i)
+ */
+static inline void FLEXCAN_ClearMsgBuffIntStatusWord(CAN_Type * base, uint32_t word, uint32_t mask)
+{
+    if (word == 0U)
+    {
+        (base->IFLAG1) = (mask);
+    }
+#if FEATURE_CAN_MAX_MB_NUM > 32U
+    if (word == 1U)
+    {
+        (base->IFLAG2) = (mask);
+    }
+#endif
+#if FEATURE_CAN_MAX_MB_NUM > 64U
+    if (word == 2U)
+    {
+        (base->IFLAG3) = (mask);
+    }
+#endif
+}
+
 /*!
  * @brief Get the interrupt flag of the message buffers.
  *
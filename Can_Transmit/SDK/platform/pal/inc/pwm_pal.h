@@ -196,6 +196,19 @@ extern "C" {
  */
  status_t PWM_UpdateDuty(const pwm_instance_t * const instance, uint8_t channel, uint32_t duty);
 
+/*!
+ * @brief Update duty cycle with sub-tick resolution. The average duty over 32 PWM periods
+ * is duty + fraction / 32 ticks. Only available on instances with PWM edge dithering
+ * (FTM1 and FTM2 on devices that support it); other instances return STATUS_UNSUPPORTED.
+ *
+ * @param[in] instance The name of the instance
+ * @param[in] channel The channel which is update
+ * @param[in] duty The integer part of the duty cycle measured in ticks
+ * @param[in] fraction The fractional part, in 1/32 tick (0 - 31)
+ * @return    Error or success status returned by API
+ */
+ status_t PWM_UpdateDutyFractional(const pwm_instance_t * const instance, uint8_t channel, uint32_t duty, uint8_t fraction);
+
 /*!
  * @brief  Update period for specific a specific channel. This function changes period for
  * all channels which shares the timebase with targeted channel.
@@ -658,6 +658,44 @@ status_t PWM_UpdateDuty(const pwm_instance_t * const instance, uint8_t channel,
     return status;
 }
 
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : PWM_UpdateDutyFractional
+ * Description   : Update duty cycle with a fractional part of 1/32 tick. The
+ * fraction is applied by the FTM edge dithering, so the average high time over
+ * 32 periods is duty + fraction / 32 ticks. Both parts are loaded at the same
+ * synchronization point.
+ *
+ *END**************************************************************************/
+status_t PWM_UpdateDutyFractional(const pwm_instance_t * const instance, uint8_t channel, uint32_t duty, uint8_t fraction)
+{
+    DEV_ASSERT(instance != NULL);
+    status_t status = STATUS_UNSUPPORTED;
+
+    #if (defined(PWM_OVER_FTM) && FEATURE_FTM_HAS_SUPPORTED_DITHERING)
+    /* Edge dithering is only implemented on FTM1 and FTM2 */
+    if ((instance->instType == PWM_INST_TYPE_FTM) && ((instance->instIdx == 1U) || (instance->instIdx == 2U)))
+    {
+        if (fraction < 32U)
+        {
+            (void)FTM_DRV_UpdatePwmEdgeChannelDither(instance->instIdx, channel, fraction, false);
+            /* The software trigger of the duty update loads both values */
+            status = PWM_UpdateDuty(instance, channel, duty);
+        }
+        else
+        {
+            status = STATUS_ERROR;
+        }
+    }
+    #else
+    (void)channel;
+    (void)duty;
+    (void)fraction;
+    #endif
+
+    return status;
+}
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : PWM_UpdatePeriod
@@ -1,5 +1,124 @@
 #include "S32K144.h"  // Thu vien dinh nghia cac thanh ghi
-#define MSG_BUF_SIZE  4  // So tu trong 1 bo dem tin nhan (2 tu header + 2 tu du lieu)
+#include "s32_core_cm4.h" // REV_BYTES_32
+#include <stddef.h>
+#include <string.h>
+#include <interrupt_manager.h>
+#include <FlexCan.h>
+#include "can_timing.h"
+
+/* Khong bien dich neu thoi gian bit khong dat duoc */
+CAN_TIMING_CHECK(FLEXCAN0_CLK_HZ, FLEXCAN0_BITRATE, FLEXCAN0_SAMPLE_POINT, FLEXCAN0_CLK_TOL_PPM);
+#if FLEXCAN0_FD_ENABLE
+CAN_TIMING_FD_CHECK(FLEXCAN0_CLK_HZ, FLEXCAN0_FD_BITRATE, FLEXCAN0_FD_SAMPLE_POINT);
+#endif
+
+/* Thoi gian cho huy bo dem toi da (thoi gian bit danh dinh): khung dang truyen
+ * chi ket thuc sau mot khung day du, khung FD 64 byte dai nhat con ngan hon */
+#define FLEXCAN0_ABORT_TIMEOUT  (1024UL)
+
+volatile flexcan_seq_stats_t g_flexcan0_seq_stats = {0, 0, 0, 0};
+
+static uint8_t s_tx_seq = 0;         // So thu tu cua khung gui tiep theo (FLEXCAN0_SEQ_HEADER_ENABLE)
+
+/* Khung truyen xong co co IFLAG da bi xoa, chua cong vao FLEXCAN0_poll_bus_stats() */
+static uint32_t s_tx_done = 0;
+/* ECR o lan FLEXCAN0_poll_bus_stats() truoc */
+static uint32_t s_last_ecr = 0;
+
+#if FLEXCAN0_SEQ_HEADER_ENABLE
+static uint8_t s_rx_seq = 0;         // So thu tu mong doi o khung nhan tiep theo
+static uint32_t s_rx_seq_valid = 0;  // 0 cho den khi nhan khung dau tien
+#endif
+
+/* Ham bao co khung nhan (goi trong ngat), NULL khi RX dung polling */
+static void (*s_rx_notify)(void) = NULL;
+
+/* Gia tri thoi gian mo rong gan nhat (mot tu duy nhat, ISR va main deu cap nhat duoc) */
+static volatile uint32_t s_time_ext = 0;
+
+/*
+ * Cap nhat thoi gian mo rong theo gia tri 16 bit now16 (gia su chua tran qua
+ * mot vong). Neu bi ngat giua chung, gia tri ghi de cung hop le nen khong can khoa.
+ */
+static uint32_t FLEXCAN0_time_update(uint16_t now16) {
+    uint32_t last = s_time_ext;
+    uint32_t now = last + (uint16_t)(now16 - (uint16_t)last);
+
+    s_time_ext = now;
+    return now;
+}
+
+/*
+ * Mo rong dau thoi gian 16 bit duoc chup toi da mot vong truoc now.
+ */
+static uint32_t FLEXCAN0_time_extend(uint16_t stamp, uint32_t now) {
+    return now - (uint16_t)((uint16_t)now - stamp);
+}
+
+/* Do dai du lieu tuong ung voi tung ma DLC (bang CAN FD, classic chi dung 0..8) */
+static const uint8_t s_dlc_to_len[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+
+#if FLEXCAN0_FD_ENABLE
+#define FLEXCAN0_MAX_DLC  (15U)
+#else
+#define FLEXCAN0_MAX_DLC  (8U)
+#endif
+
+/*
+ * DLC nho nhat chua du length byte, gioi han theo kich thuoc bo dem.
+ */
+static uint8_t FLEXCAN0_len_to_dlc(uint32_t length) {
+    uint8_t dlc = 0;
+
+    if (length > FLEXCAN0_PAYLOAD_SIZE) {
+        length = FLEXCAN0_PAYLOAD_SIZE;
+    }
+    while ((dlc < FLEXCAN0_MAX_DLC) && (s_dlc_to_len[dlc] < length)) {
+        dlc++;
+    }
+    return dlc;
+}
+
+/*
+ * Chep du lieu vao cac tu du lieu cua bo dem. FlexCAN luu byte 0 o byte cao
+ * nhat cua moi tu nen moi tu duoc dao byte mot lan (REV_BYTES_32).
+ * Cac byte tu length den kich thuoc cua DLC duoc gui la 0.
+ */
+static void FLEXCAN0_write_payload(uint32_t mb, const uint8_t *data, uint32_t length, uint32_t dlcLength) {
+    volatile uint32_t *mbData = &CAN0->RAMn[mb * MSG_BUF_SIZE + 2];
+    uint32_t words = (dlcLength + 3U) >> 2;
+    uint32_t w;
+
+    for (w = 0; w < words; w++) {
+        uint32_t x = 0;
+        uint32_t y;
+        uint32_t offset = w << 2;
+
+        if ((offset + 4U) <= length) {
+            memcpy(&x, &data[offset], 4U);
+        } else if (offset < length) {
+            memcpy(&x, &data[offset], length - offset);
+        }
+        REV_BYTES_32(x, y);
+        mbData[w] = y;
+    }
+}
+
+/*
+ * Doc length byte tu bo dem theo tung tu (data phai chua du length lam tron len 4).
+ */
+static void FLEXCAN0_read_payload(uint32_t mb, uint8_t *data, uint32_t length) {
+    volatile const uint32_t *mbData = &CAN0->RAMn[mb * MSG_BUF_SIZE + 2];
+    uint32_t words = (length + 3U) >> 2;
+    uint32_t w;
+
+    for (w = 0; w < words; w++) {
+        uint32_t x = mbData[w];
+        uint32_t y;
+        REV_BYTES_32(x, y);
+        memcpy(&data[w << 2], &y, 4U);
+    }
+}
 
 void FLEXCAN0_init(void) {
     uint32_t i = 0;
@@ -9,17 +128,31 @@ void FLEXCAN0_init(void) {
     // Vo hieu hoa module truoc khi cau hinh
     CAN0->MCR |= CAN_MCR_MDIS_MASK;
     // CAN0->MCR |= 1UL << CAN_MCR_MDIS_SHIFT; // Hoac co the viet nhu the nay 1UL << 31
-    // Chon nguon clock 8 MHz tu oscillator
-     CAN0->CTRL1 &= ~CAN_CTRL1_CLKSRC_MASK;
+    // Chon nguon clock (chi ghi duoc khi MDIS = 1)
+     CAN0->CTRL1 = (CAN0->CTRL1 & ~CAN_CTRL1_CLKSRC_MASK) | CAN_CTRL1_CLKSRC(FLEXCAN0_CLK_SRC);
     // CAN0->CTRL1 &= ~(1UL << 16)
     CAN0->MCR |= (CAN_MCR_FRZ_MASK | CAN_MCR_HALT_MASK);
     // Kich hoat module tro lai (vao che do freeze de cau hinh)
     CAN0->MCR &= ~CAN_MCR_MDIS_MASK;
     while (!((CAN0->MCR & CAN_MCR_FRZACK_MASK) >> CAN_MCR_FRZACK_SHIFT)) {}
     // FRZACK = 1, cho phep cau hinh module CAN vao che do freeze(xac nhan FRZACK = 1)
-    // Cau hinh toc do CAN 500 kHz (tham so CAN0->CTRL1)
-    CAN0->CTRL1 = 0x00DB0006;
-    // Xoa toan bo bo dem tin nhan (128 words tuong ung 32 buffer * 4 words)
+    // Cau hinh toc do CAN (FLEXCAN0_BITRATE tu FLEXCAN0_CLK_HZ, 500 kbps/8 MHz = 0x00DB0006)
+    CAN0->CTRL1 = CAN_TIMING_CTRL1(FLEXCAN0_CLK_SRC, FLEXCAN0_CLK_HZ, FLEXCAN0_BITRATE, FLEXCAN0_SAMPLE_POINT);
+    // Cho phep huy khung dang cho truyen (CODE=0x9), dung boi FLEXCAN0_replace_msg()
+    CAN0->MCR |= CAN_MCR_AEN_MASK;
+#if FLEXCAN0_FD_ENABLE
+    // Pha danh dinh qua CBT (cung cac doan nhu CTRL1 o tren), pha du lieu FLEXCAN0_FD_BITRATE
+    CAN0->MCR |= CAN_MCR_FDEN_MASK;
+    CAN0->MCR = (CAN0->MCR & ~CAN_MCR_MAXMB_MASK) | CAN_MCR_MAXMB(FLEXCAN0_MB_COUNT - 1UL);
+    CAN0->CBT = CAN_TIMING_CBT(FLEXCAN0_CLK_HZ, FLEXCAN0_BITRATE, FLEXCAN0_SAMPLE_POINT);
+    CAN0->FDCBT = CAN_TIMING_FDCBT(FLEXCAN0_CLK_HZ, FLEXCAN0_FD_BITRATE, FLEXCAN0_FD_SAMPLE_POINT);
+    // MBDSR0: 0 = 8, 1 = 16, 2 = 32, 3 = 64 byte moi bo dem
+    CAN0->FDCTRL = CAN_FDCTRL_FDRATE_MASK |
+                   CAN_FDCTRL_MBDSR0((FLEXCAN0_PAYLOAD_SIZE == 8UL)  ? 0UL :
+                                     (FLEXCAN0_PAYLOAD_SIZE == 16UL) ? 1UL :
+                                     (FLEXCAN0_PAYLOAD_SIZE == 32UL) ? 2UL : 3UL);
+#endif
+    // Xoa toan bo RAM bo dem tin nhan (128 words)
     for (i = 0; i < 128; i++) {
         CAN0->RAMn[i] = 0;
     }
@@ -30,9 +163,20 @@ void FLEXCAN0_init(void) {
     // khai bao toan cuc cho phep nhan tat ca cac ID(29bit)
     CAN0->RXMGMASK = 0x1FFFFFFF;
     // Cau hinh bo dem 4 nhan tin nhan voi ID chuan, chua kich hoat (CODE=4)
-    CAN0->RAMn[4*MSG_BUF_SIZE + 1] = 2UL << 18; //ID_receive = 2
+    CAN0->RAMn[RX_MAILBOX*MSG_BUF_SIZE + 1] = RX_MSG_ID << 18; //ID_receive = 2
     // id[28-18] = 10100010001 = 1297 = 0x111 (hex)
-    CAN0->RAMn[4*MSG_BUF_SIZE + 0] = 0x04000000; // CODE=4 (RX inactive)
+    CAN0->RAMn[RX_MAILBOX*MSG_BUF_SIZE + 0] = 0x04000000; // CODE=4 (RX inactive)
+    // Dat cac bo dem truyen ve trang thai TX INACTIVE (CODE=8)
+    for (i = 0; i < TX_MAILBOX_COUNT; i++) {
+        CAN0->RAMn[(TX_MAILBOX_FIRST + i)*MSG_BUF_SIZE + 0] = MB_CODE_TX_INACTIVE << MB_CODE_SHIFT;
+    }
+    s_tx_done = 0;
+    s_last_ecr = 0;
+    s_time_ext = 0;
+    s_tx_seq = 0;
+#if FLEXCAN0_SEQ_HEADER_ENABLE
+    s_rx_seq_valid = 0;
+#endif
     // Kich hoat module CAN, thoat freeze mode
     CAN0->MCR &= ~(CAN_MCR_FRZ_MASK | CAN_MCR_HALT_MASK);
     // => Xóa FRZ=0, HALT=0: Cho phép CAN hoạt động bình thường
@@ -43,52 +187,400 @@ void FLEXCAN0_init(void) {
     // => Đợi NOTRDY=0: Module CAN sẵn sàng hoạt động
 }
 
-void FLEXCAN0_transmit_msg(uint8_t buffer[]) {
-    // Xoa co cu cua bo dem 0
-    CAN0->IFLAG1 = 0x00000001;
+/*
+ * Bo dem dang ban khi CODE=0xC: khung dang cho phan xu (arbitration) hoac dang
+ * truyen. Khi truyen xong FlexCAN tu dat CODE=0x8 va bat co IFLAG tuong ung.
+ * CODE=0x9 ma co chua bat la lan huy con dang cho, cung tinh la ban.
+ */
+static uint32_t FLEXCAN0_tx_busy(uint32_t mb) {
+    uint32_t code = (CAN0->RAMn[mb*MSG_BUF_SIZE + 0] & MB_CODE_MASK) >> MB_CODE_SHIFT;
+
+    if (code == MB_CODE_TX_ABORT) {
+        return ((CAN0->IFLAG1 & (1UL << mb)) == 0UL) ? 1UL : 0UL;
+    }
+    return (code == MB_CODE_TX_DATA) ? 1UL : 0UL;
+}
+
+/*
+ * Xoa co IFLAG cua cac bo dem truyen trong mask; moi co dang bat la mot khung
+ * da truyen xong, duoc dem vao s_tx_done truoc khi xoa.
+ */
+static void FLEXCAN0_tx_ack(uint32_t mask) {
+    uint32_t done = CAN0->IFLAG1 & mask;
+
+    if (done != 0UL) {
+        s_tx_done += (uint32_t)__builtin_popcount(done);
+        CAN0->IFLAG1 = done;
+    }
+}
 
-    // Cau hinh ID chuan cho bo dem 0
-    CAN0->RAMn[0*MSG_BUF_SIZE + 1] = (0x01 << 18); // ID= 1
+/*
+ * Giua cac khung cung ID, FlexCAN gui bo dem so nho truoc. Tra ve vi tri trong
+ * nhom TX ngay tren bo dem cao nhat con giu khung ID id chua truyen xong
+ * (0 neu khong co): khung moi cung ID chi duoc nap tu vi tri nay tro len de
+ * len bus sau cac khung da gui truoc no.
+ */
+static uint32_t FLEXCAN0_tx_id_floor(uint32_t id) {
+    uint32_t idWord = (id & 0x7FFUL) << 18;
+    uint32_t n;
 
-    // Cau hinh bo dem 1 kich hoat truyen voi DLC=8 bytes, CODE=0xC (TX frame)
-    CAN0->RAMn[0*MSG_BUF_SIZE + 0] = 0x0C400000 | (4 << CAN_WMBn_CS_DLC_SHIFT);
+    for (n = TX_MAILBOX_COUNT; n > 0UL; n--) {
+        uint32_t mb = TX_MAILBOX_FIRST + n - 1UL;
 
-    // Gan du lieu gui vao RAM bo dem (gop 4 bytes dau thanh 1 word)
-    uint32_t dataWord = 0;
-    dataWord |= buffer[0];
-    dataWord |= ((uint32_t)buffer[1] << 8);
-    dataWord |= ((uint32_t)buffer[2] << 16);
-    dataWord |= ((uint32_t)buffer[3] << 24);
+        if ((FLEXCAN0_tx_busy(mb) != 0UL) && (CAN0->RAMn[mb*MSG_BUF_SIZE + 1] == idWord)) {
+            break;
+        }
+    }
+    return n;
+}
 
-    CAN0->RAMn[0*MSG_BUF_SIZE+2] = dataWord;  // Ghi du lieu vao word 2 cua MB1 (doan du lieu)
+/**
+ * Gui mot khung voi ID TX_MSG_ID, xem FLEXCAN0_transmit_msg_id().
+ */
+status_t FLEXCAN0_transmit_msg(const uint8_t buffer[], uint8_t length, uint8_t *mailbox) {
+    return FLEXCAN0_transmit_msg_id(TX_MSG_ID, buffer, length, mailbox);
 }
 
+/*
+ * Nap khung vao bo dem truyen mb (khong ban) va kich hoat truyen. Voi
+ * FLEXCAN0_SEQ_HEADER_ENABLE, seq duoc chen vao byte 0.
+ */
+static void FLEXCAN0_load_mailbox(uint32_t mb, uint32_t id, const uint8_t buffer[], uint8_t length, uint8_t seq) {
+#if FLEXCAN0_SEQ_HEADER_ENABLE
+    uint8_t staged[FLEXCAN0_PAYLOAD_SIZE];
+
+    if (length > (FLEXCAN0_PAYLOAD_SIZE - 1U)) {
+        length = FLEXCAN0_PAYLOAD_SIZE - 1U;
+    }
+    staged[0] = seq;
+    memcpy(&staged[1], buffer, length);
+    buffer = staged;
+    length++;
+#else
+    (void)seq;
+#endif
+
+    uint8_t dlc = FLEXCAN0_len_to_dlc(length);
+    uint32_t cs = 0x0C400000 | ((uint32_t)dlc << CAN_WMBn_CS_DLC_SHIFT);
+
+#if FLEXCAN0_FD_ENABLE
+    cs |= MB_CS_EDL_MASK | MB_CS_BRS_MASK;
+#endif
+
+    // Xoa co cu cua bo dem (khung truoc da truyen xong thi duoc dem)
+    FLEXCAN0_tx_ack(1UL << mb);
+
+    // Gan du lieu gui vao RAM bo dem (theo tung tu)
+    FLEXCAN0_write_payload(mb, buffer, length, s_dlc_to_len[dlc]);
+
+    // Cau hinh ID chuan cho bo dem
+    CAN0->RAMn[mb*MSG_BUF_SIZE + 1] = ((id & 0x7FFUL) << 18);
+
+    // Kich hoat truyen sau cung, CODE=0xC (TX frame)
+    CAN0->RAMn[mb*MSG_BUF_SIZE + 0] = cs;
+}
+
+/**
+ * Gui mot khung qua bo dem truyen trong thap nhat cua nhom TX nam tren moi bo
+ * dem con giu khung cung ID, nen cac khung cung ID len bus dung thu tu gui.
+ *
+ * @param id      ID chuan 11 bit
+ * @param buffer  Du lieu can gui
+ * @param length  So byte (toi da FLEXCAN0_PAYLOAD_SIZE, bot 1 neu dung
+ *                FLEXCAN0_SEQ_HEADER_ENABLE)
+ * @param mailbox Tra ve so bo dem da dung (co the la NULL)
+ * @return STATUS_SUCCESS neu khung da duoc xep hang,
+ *         STATUS_BUSY neu khong con bo dem trong nao nhu vay (khong ghi de)
+ */
+status_t FLEXCAN0_transmit_msg_id(uint32_t id, const uint8_t buffer[], uint8_t length, uint8_t *mailbox) {
+    uint32_t n;
+
+    for (n = FLEXCAN0_tx_id_floor(id); n < TX_MAILBOX_COUNT; n++) {
+        uint32_t mb = TX_MAILBOX_FIRST + n;
+
+        if (FLEXCAN0_tx_busy(mb) != 0UL) {
+            continue;
+        }
 
-uint32_t FLEXCAN0_receive_msg(uint8_t *buffer_rx) {
+        FLEXCAN0_load_mailbox(mb, id, buffer, length, s_tx_seq);
+        s_tx_seq++;
+        if (mailbox != NULL) {
+            *mailbox = (uint8_t)mb;
+        }
+        return STATUS_SUCCESS;
+    }
+
+    return STATUS_BUSY;
+}
+
+/**
+ * Thay khung ID TX_MSG_ID da gui qua bo dem mailbox bang khung moi.
+ * Neu khung cu van dang cho phan xu, no bi huy (CODE=0x9) va khong xuat hien
+ * tren bus; neu no da truyen xong hoac dang truyen (khong huy duoc), khung
+ * moi duoc gui ngay sau no trong cung bo dem. Ham cho toi da mot khung.
+ * Khung moi khong duoc vuot khung ID TX_MSG_ID gui sau khung cu: khi khung cu
+ * da len bus ma bo dem so lon hon con giu khung nhu vay, ham tra ve STATUS_BUSY.
+ *
+ * @param mailbox Bo dem tra ve boi FLEXCAN0_transmit_msg()
+ * @param buffer  Du lieu moi
+ * @param length  So byte, nhu FLEXCAN0_transmit_msg_id()
+ * @return STATUS_SUCCESS, STATUS_ERROR neu mailbox khong thuoc nhom TX,
+ *         STATUS_TIMEOUT neu lan huy chua xong sau FLEXCAN0_ABORT_TIMEOUT
+ *         (goi lai sau de tiep tuc cho), STATUS_BUSY neu phai cho khung
+ *         cung ID o bo dem so lon hon len bus
+ */
+status_t FLEXCAN0_replace_msg(uint8_t mailbox, const uint8_t buffer[], uint8_t length) {
+    uint32_t mb = mailbox;
+    uint8_t seq = s_tx_seq;
+    uint32_t aborted = 0;
+    uint32_t cs;
+    uint32_t code;
+
+    if ((mb - TX_MAILBOX_FIRST) >= TX_MAILBOX_COUNT) {
+        return STATUS_ERROR;
+    }
+
+    cs = CAN0->RAMn[mb*MSG_BUF_SIZE + 0];
+    code = (cs & MB_CODE_MASK) >> MB_CODE_SHIFT;
+    if ((code == MB_CODE_TX_DATA) || (code == MB_CODE_TX_ABORT)) {
+        // FLEXCAN0_load_mailbox() da xoa co cu, nen co IFLAG dang bat la cua
+        // khung nay: no vua truyen xong (CODE=0x8) hoac da huy xong (CODE=0x9).
+        // Chi yeu cau huy khi co chua bat (quy trinh huy cua reference manual);
+        // CODE=0x9 ma chua co co la lan huy truoc con dang cho
+        if ((CAN0->IFLAG1 & (1UL << mb)) == 0UL) {
+            uint32_t start;
+
+            if (code == MB_CODE_TX_DATA) {
+                CAN0->RAMn[mb*MSG_BUF_SIZE + 0] = (cs & ~MB_CODE_MASK) | (MB_CODE_TX_ABORT << MB_CODE_SHIFT);
+            }
+            start = FLEXCAN0_get_time();
+            while ((CAN0->IFLAG1 & (1UL << mb)) == 0UL) {
+                if ((FLEXCAN0_get_time() - start) > FLEXCAN0_ABORT_TIMEOUT) {
+                    return STATUS_TIMEOUT;
+                }
+            }
+        }
+
+        cs = CAN0->RAMn[mb*MSG_BUF_SIZE + 0];
+        if (((cs & MB_CODE_MASK) >> MB_CODE_SHIFT) == MB_CODE_TX_ABORT) {
+            // Khung cu khong len bus: khung moi dung lai so thu tu cua no,
+            // co cua lan huy khong duoc dem la khung truyen xong
+            seq = (uint8_t)(CAN0->RAMn[mb*MSG_BUF_SIZE + 2] >> 24);
+            CAN0->IFLAG1 = (1UL << mb);
+            aborted = 1;
+        }
+    }
+    // Khung moi (khong thay cho khung da huy) xep sau khung cung ID dang cho
+    if ((aborted == 0UL) && (FLEXCAN0_tx_id_floor(TX_MSG_ID) > (mb - TX_MAILBOX_FIRST))) {
+        return STATUS_BUSY;
+    }
+
+    FLEXCAN0_load_mailbox(mb, TX_MSG_ID, buffer, length, seq);
+    if (seq == s_tx_seq) {
+        s_tx_seq++;
+    }
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Thoi gian hien tai cua FlexCAN, mo rong len 32 bit.
+ * Doc TIMER se mo khoa bo dem dang bi khoa, khong goi giua luc doc bo dem.
+ *
+ * @return Thoi gian theo don vi FLEXCAN0_TIMER_HZ
+ */
+uint32_t FLEXCAN0_get_time(void) {
+    return FLEXCAN0_time_update((uint16_t)CAN0->TIMER);
+}
+
+/**
+ * Dau thoi gian phan cung cua khung da gui tu bo dem mailbox.
+ *
+ * @param mailbox   Bo dem tra ve boi FLEXCAN0_transmit_msg()
+ * @param timestamp Thoi gian gui (don vi FLEXCAN0_TIMER_HZ)
+ * @return 1 neu khung da roi bo dieu khien, 0 neu con dang cho
+ */
+uint32_t FLEXCAN0_get_tx_time(uint8_t mailbox, uint32_t *timestamp) {
+    uint32_t cs = CAN0->RAMn[mailbox*MSG_BUF_SIZE + 0];
+
+    if (((cs & MB_CODE_MASK) >> MB_CODE_SHIFT) == MB_CODE_TX_DATA) {
+        return 0;
+    }
+    *timestamp = FLEXCAN0_time_extend((uint16_t)(cs & MB_TIMESTAMP_MASK), FLEXCAN0_get_time());
+    return 1;
+}
+
+/**
+ * Cong don thong ke duong truyen tu lan goi truoc. Khung truyen xong duoc dem
+ * ca khi co IFLAG da bi xoa luc nap lai bo dem. Loi duoc suy ra tu muc tang
+ * cua TXERRCNT/RXERRCNT nen can goi it nhat vai lan moi giay.
+ *
+ * @param stats Bo dem thong ke can cong don
+ */
+void FLEXCAN0_poll_bus_stats(flexcan_bus_stats_t *stats) {
+    static uint32_t s_arb_wait = 0;
+    uint32_t pool = ((1UL << TX_MAILBOX_COUNT) - 1UL) << TX_MAILBOX_FIRST;
+    uint32_t esr1 = CAN0->ESR1;
+    uint32_t ecr = CAN0->ECR;
+    uint32_t tec = (ecr & CAN_ECR_TXERRCNT_MASK) >> CAN_ECR_TXERRCNT_SHIFT;
+    uint32_t rec = (ecr & CAN_ECR_RXERRCNT_MASK) >> CAN_ECR_RXERRCNT_SHIFT;
+    uint32_t last_tec = (s_last_ecr & CAN_ECR_TXERRCNT_MASK) >> CAN_ECR_TXERRCNT_SHIFT;
+    uint32_t last_rec = (s_last_ecr & CAN_ECR_RXERRCNT_MASK) >> CAN_ECR_RXERRCNT_SHIFT;
+    uint32_t waiting;
+
+    // Khung truyen xong: dem va xoa co, cong ca cac co da xoa khi nap bo dem
+    FLEXCAN0_tx_ack(pool);
+    stats->tx_done += s_tx_done;
+    s_tx_done = 0;
+
+    // Co khung dang cho nhung FlexCAN dang nhan (nut khac thang phan xu):
+    // chi dem canh len cua trang thai nay
+    waiting = ((FLEXCAN0_tx_occupancy() != 0UL) &&
+               ((esr1 & (CAN_ESR1_RX_MASK | CAN_ESR1_TX_MASK)) == CAN_ESR1_RX_MASK)) ? 1UL : 0UL;
+    if ((waiting != 0UL) && (s_arb_wait == 0UL)) {
+        stats->arb_lost++;
+    }
+    s_arb_wait = waiting;
+
+    // Khung loi: moi loi khi truyen tang TXERRCNT 8, khi nhan tang RXERRCNT 1;
+    // moi khung thanh cong giam 1 nen gia tri la can duoi
+    if (tec > last_tec) {
+        stats->error_frames += (tec - last_tec + 7UL) / 8UL;
+    }
+    if (rec > last_rec) {
+        stats->error_frames += rec - last_rec;
+    }
+    s_last_ecr = ecr;
+}
+
+/**
+ * Trang thai chiem dung cua nhom bo dem truyen.
+ *
+ * @return Bit n = 1 neu bo dem TX_MAILBOX_FIRST + n dang co khung chua truyen xong
+ */
+uint32_t FLEXCAN0_tx_occupancy(void) {
+    uint32_t busy = 0;
+    uint32_t n;
+
+    for (n = 0; n < TX_MAILBOX_COUNT; n++) {
+        busy |= FLEXCAN0_tx_busy(TX_MAILBOX_FIRST + n) << n;
+    }
+    return busy;
+}
+
+#if FLEXCAN0_SEQ_HEADER_ENABLE
+/*
+ * Dem so thu tu o byte 0 cua khung nhan va bo byte nay khoi du lieu.
+ * Khoang cach 8 bit d toi so mong doi: 0 < d < 128 la mat d khung,
+ * d >= 128 la khung lap lai hoac den tre.
+ *
+ * @return So byte du lieu con lai
+ */
+static uint32_t FLEXCAN0_seq_check(uint8_t *data, uint32_t length) {
+    uint8_t seq;
+    uint8_t diff;
+
+    if (length == 0U) {
+        return 0U; // Khong co byte thu tu
+    }
+    seq = data[0];
+    length--;
+    memmove(data, &data[1], length);
+    data[length] = 0;
+
+    g_flexcan0_seq_stats.received++;
+    diff = (uint8_t)(seq - s_rx_seq);
+    if ((s_rx_seq_valid == 0U) || (diff == 0U)) {
+        s_rx_seq_valid = 1;
+    } else if (diff < 128U) {
+        g_flexcan0_seq_stats.lost += diff;
+    } else if (seq == (uint8_t)(s_rx_seq - 1U)) {
+        g_flexcan0_seq_stats.duplicated++;
+        return length;
+    } else {
+        g_flexcan0_seq_stats.out_of_order++;
+        if (g_flexcan0_seq_stats.lost != 0U) {
+            g_flexcan0_seq_stats.lost--; // Da bi dem la mat khi thay khoang trong
+        }
+        return length;
+    }
+    s_rx_seq = (uint8_t)(seq + 1U);
+    return length;
+}
+#endif
+
+/*
+ * Ngat bo dem nhan: tat ngat cua RX_MAILBOX (bat lai khi khung da duoc doc
+ * trong FLEXCAN0_receive_msg()) va bao cho ung dung. Khung khong duoc doc
+ * trong ngat.
+ */
+static void FLEXCAN0_rx_isr(void) {
+    if ((CAN0->IFLAG1 & CAN0->IMASK1 & (1UL << RX_MAILBOX)) != 0UL) {
+        CAN0->IMASK1 &= ~(1UL << RX_MAILBOX);
+        s_rx_notify();
+    }
+}
+
+/*
+ * Bat lai ngat nhan sau khi doc bo dem (chi khi dang dung ngat).
+ */
+static void FLEXCAN0_rx_rearm(void) {
+    if (s_rx_notify != NULL) {
+        CAN0->IMASK1 |= (1UL << RX_MAILBOX);
+    }
+}
+
+/**
+ * Bao khung nhan bang ngat thay vi polling. notify chay trong ngat moi khi
+ * RX_MAILBOX co khung; ngat tiep theo chi xay ra sau khi ung dung goi
+ * FLEXCAN0_receive_msg().
+ *
+ * @param notify Ham goi trong ngat, vi du de dang su kien cho scheduler
+ */
+void FLEXCAN0_enable_rx_irq(void (*notify)(void)) {
+    s_rx_notify = notify;
+    INT_SYS_InstallHandler(CAN0_ORed_0_15_MB_IRQn, &FLEXCAN0_rx_isr, NULL);
+    CAN0->IMASK1 |= (1UL << RX_MAILBOX);
+    INT_SYS_EnableIRQ(CAN0_ORed_0_15_MB_IRQn);
+}
+
+/**
+ * Doc khung nhan duoc tu bo dem RX_MAILBOX.
+ *
+ * @param buffer_rx Bo dem nhan, kich thuoc FLEXCAN0_PAYLOAD_SIZE byte
+ * @param timestamp Thoi gian nhan (don vi FLEXCAN0_TIMER_HZ), co the la NULL
+ * @return So byte nhan duoc (0 neu chua co khung)
+ */
+uint32_t FLEXCAN0_receive_msg(uint8_t *buffer_rx, uint32_t *timestamp) {
 //    if (buffer_rx == NULL) {
 //        return 0;  // Kiểm tra con trỏ đầu vào
 //    }
 
-    /* Đọc thông tin từ MB4 */
-    uint32_t RxCODE = (CAN0->RAMn[4 * 4 + 0] & 0x07000000) >> 24;  /* CODE field */
-    if (RxCODE != 0x2) { // MB trong
+    /* Đọc thông tin từ MB4 (doc CS se khoa bo dem) */
+    uint32_t cs = CAN0->RAMn[RX_MAILBOX * MSG_BUF_SIZE + 0];
+    uint32_t RxCODE = (cs & MB_CODE_MASK) >> MB_CODE_SHIFT;  /* CODE field */
+    if ((RxCODE != MB_CODE_RX_FULL) && (RxCODE != MB_CODE_RX_OVRN)) { // MB trong
+        FLEXCAN0_rx_rearm();
         return 0;  // Kiểm tra mã trạng thái
     }
     // RxID = (CAN0->RAMn[4 * 4 + 1] & CAN_WMBn_ID_ID_MASK) >> CAN_WMBn_ID_ID_SHIFT; do ham ngat da ktra ID roi
-    uint32_t RxLENGTH = (CAN0->RAMn[4 * 4 + 0] & CAN_WMBn_CS_DLC_MASK) >> CAN_WMBn_CS_DLC_SHIFT;
-    uint32_t RxDATA = CAN0->RAMn[4 * 4 + 2];  /* Đọc 4 byte dữ liệu từ word 2 */
-    for (uint32_t i = 0; i < RxLENGTH && i < 4; i++) {
-            buffer_rx[i] = (RxDATA >> (i * 8)) & 0xFF; // Lưu trực tiếp vào buffer
-        }
-    for (uint32_t i = RxLENGTH; i < 4; i++) {
-        buffer_rx[i] = 0; // Xóa byte không hợp lệ
+    uint32_t RxLENGTH = s_dlc_to_len[(cs & CAN_WMBn_CS_DLC_MASK) >> CAN_WMBn_CS_DLC_SHIFT];
+    if (RxLENGTH > FLEXCAN0_PAYLOAD_SIZE) {
+        RxLENGTH = FLEXCAN0_PAYLOAD_SIZE;
     }
+    memset(buffer_rx, 0, FLEXCAN0_PAYLOAD_SIZE); // Xóa byte không hợp lệ
+    FLEXCAN0_read_payload(RX_MAILBOX, buffer_rx, RxLENGTH);
 
-    /* Đọc TIMESTAMP từ MB4 (sửa lỗi từ MB0) */
-//    uint32_t RxTIMESTAMP = (CAN0->RAMn[4 * 4 + 0] & 0x0000FFFF);
+    /* Mở khóa MB (doc TIMER) va mo rong TIMESTAMP cua MB4 theo thoi gian hien tai */
+    uint32_t now = FLEXCAN0_get_time();
+    if (timestamp != NULL) {
+        *timestamp = FLEXCAN0_time_extend((uint16_t)(cs & MB_TIMESTAMP_MASK), now);
+    }
 
-    /* Mở khóa MB và xóa cờ ngắt */
-    (void)CAN0->TIMER;           /* Mở khóa MB */
-    CAN0->IFLAG1 = 0x00000010;     /* Xóa cờ MB4 */
+    /* Xóa cờ ngắt */
+    CAN0->IFLAG1 = (1UL << RX_MAILBOX);     /* Xóa cờ MB4 */
+    FLEXCAN0_rx_rearm();
+#if FLEXCAN0_SEQ_HEADER_ENABLE
+    RxLENGTH = FLEXCAN0_seq_check(buffer_rx, RxLENGTH);
+#endif
     return RxLENGTH;
 }
@@ -7,10 +7,105 @@
 #ifndef FLEXCAN_H_
 #define FLEXCAN_H_
 
+#include <stdint.h>
+#include "status.h"
+
        /* If using 2 boards as 2 nodes, NODE A & B use different CAN IDs */
 
+/* Thoi gian bit, duoc tinh luc bien dich boi can_timing.h.
+ * FLEXCAN0_CLK_SRC: 0 = bo dao dong (SOSCDIV2), 1 = bus clock. */
+#define FLEXCAN0_CLK_SRC          (0UL)
+#define FLEXCAN0_CLK_HZ           (8000000UL)
+#define FLEXCAN0_BITRATE          (500000UL)
+#define FLEXCAN0_SAMPLE_POINT     (75UL)      // phan tram
+#define FLEXCAN0_CLK_TOL_PPM      (1000UL)    // sai so bo dao dong ma thoi gian bit phai chiu duoc
+#define FLEXCAN0_FD_BITRATE       (1000000UL) // pha du lieu, chi dung voi FD
+#define FLEXCAN0_FD_SAMPLE_POINT  (75UL)
+
+/* Cau hinh du lieu: CAN classic toi da 8 byte; dat FLEXCAN0_FD_ENABLE = 1 de
+ * dung CAN FD (co bit rate switch), moi bo dem chua FLEXCAN0_PAYLOAD_SIZE byte
+ * (8, 16, 32 hoac 64). */
+#define FLEXCAN0_FD_ENABLE     (0)
+#define FLEXCAN0_PAYLOAD_SIZE  (8UL)
+
+#if (FLEXCAN0_PAYLOAD_SIZE != 8UL) && (FLEXCAN0_PAYLOAD_SIZE != 16UL) && \
+    (FLEXCAN0_PAYLOAD_SIZE != 32UL) && (FLEXCAN0_PAYLOAD_SIZE != 64UL)
+#error "FLEXCAN0_PAYLOAD_SIZE must be 8, 16, 32 or 64"
+#endif
+#if (FLEXCAN0_FD_ENABLE == 0) && (FLEXCAN0_PAYLOAD_SIZE != 8UL)
+#error "Payloads above 8 bytes need FLEXCAN0_FD_ENABLE"
+#endif
+
+/* Byte thu tu: 1 = byte 0 cua moi khung la bo dem thu tu 8 bit xoay vong.
+ * Duong gui danh so (du lieu ung dung con lai it hon 1 byte), duong nhan
+ * kiem tra, bo byte nay va dem vao g_flexcan0_seq_stats. Hai nut phai dung
+ * cung mot cau hinh. */
+#define FLEXCAN0_SEQ_HEADER_ENABLE  (0)
+
+#define MSG_BUF_SIZE       (2UL + (FLEXCAN0_PAYLOAD_SIZE / 4UL)) // So tu trong 1 bo dem (CS + ID + du lieu)
+#define FLEXCAN0_MB_COUNT  (128UL / MSG_BUF_SIZE)                // So bo dem vua trong RAM cua CAN0
+#define TX_MSG_ID         (1UL)  // 0x01
+#define RX_MAILBOX        (4UL)  // MB4
+#define RX_MSG_ID         (2UL)  // 0x02
+
+/* Nhom bo dem truyen: TX_MAILBOX_COUNT bo dem lien tiep bat dau tu TX_MAILBOX_FIRST */
+#define TX_MAILBOX_FIRST  (0UL)  // MB0
+#define TX_MAILBOX_COUNT  (4UL)  // MB0..MB3
+
+#if (TX_MAILBOX_COUNT == 0UL) || (TX_MAILBOX_COUNT > 16UL)
+#error "TX_MAILBOX_COUNT must be 1..16"
+#endif
+#if ((TX_MAILBOX_FIRST + TX_MAILBOX_COUNT) > FLEXCAN0_MB_COUNT) || (RX_MAILBOX >= FLEXCAN0_MB_COUNT)
+#error "Mailbox index beyond the MBs available for FLEXCAN0_PAYLOAD_SIZE"
+#endif
+#if (RX_MAILBOX >= TX_MAILBOX_FIRST) && (RX_MAILBOX < (TX_MAILBOX_FIRST + TX_MAILBOX_COUNT))
+#error "RX_MAILBOX overlaps the TX mailbox pool"
+#endif
+
+#define MB_CODE_MASK      (0x0F000000UL)
+#define MB_CODE_SHIFT     (24UL)
+#define MB_CODE_TX_INACTIVE (0x8UL) // Bo dem trong / da truyen xong
+#define MB_CODE_TX_DATA     (0xCUL) // Dang cho truyen hoac dang truyen
+#define MB_CODE_TX_ABORT    (0x9UL) // Yeu cau huy / da huy (MCR AEN = 1)
+#define MB_CODE_RX_FULL     (0x2UL)
+#define MB_CODE_RX_OVRN     (0x6UL)
+#define MB_CS_EDL_MASK      (0x80000000UL) // Khung FD
+#define MB_CS_BRS_MASK      (0x40000000UL) // Bit rate switch
+#define MB_TIMESTAMP_MASK   (0x0000FFFFUL)
+
+/* Bo dem thoi gian 16 bit cua FlexCAN dem theo thoi gian bit danh dinh.
+ * Dau thoi gian duoc mo rong len 32 bit bang phan mem: moi lan gui/nhan va
+ * FLEXCAN0_get_time() deu cap nhat so lan tran, nen phai goi it nhat mot lan
+ * trong moi 65536 thoi gian bit (131 ms voi 500 kbps). */
+#define FLEXCAN0_TIMER_HZ   FLEXCAN0_BITRATE
+
+/* Bo dem thong ke duong truyen, cong don boi FLEXCAN0_poll_bus_stats() */
+typedef struct {
+    uint32_t tx_done;      // Khung da truyen xong (co IFLAG cua nhom TX, ke ca co xoa khi nap lai)
+    uint32_t arb_lost;     // Uoc luong: co khung cho truyen trong khi nut khac chiem bus
+    uint32_t error_frames; // Khung loi, tu muc tang TXERRCNT/8 + RXERRCNT (can duoi)
+} flexcan_bus_stats_t;
+
+/* Bo dem thu tu khung (FLEXCAN0_SEQ_HEADER_ENABLE), cap nhat khi nhan */
+typedef struct {
+    uint32_t received;     // Khung co byte thu tu
+    uint32_t lost;         // So thu tu bi nhay qua (khung den tre duoc tru lai)
+    uint32_t duplicated;   // Trung so voi khung truoc
+    uint32_t out_of_order; // Cu hon khung truoc
+} flexcan_seq_stats_t;
+
+/* Bo dem truc tiep, doc duoc tu debugger */
+extern volatile flexcan_seq_stats_t g_flexcan0_seq_stats;
+
 void FLEXCAN0_init (void);
-void FLEXCAN0_transmit_msg (uint8_t[]);
-uint32_t FLEXCAN0_receive_msg (uint8_t *buffer);
+status_t FLEXCAN0_transmit_msg (const uint8_t buffer[], uint8_t length, uint8_t *mailbox);
+status_t FLEXCAN0_transmit_msg_id (uint32_t id, const uint8_t buffer[], uint8_t length, uint8_t *mailbox);
+status_t FLEXCAN0_replace_msg (uint8_t mailbox, const uint8_t buffer[], uint8_t length);
+void FLEXCAN0_poll_bus_stats (flexcan_bus_stats_t *stats);
+uint32_t FLEXCAN0_receive_msg (uint8_t *buffer, uint32_t *timestamp);
+void FLEXCAN0_enable_rx_irq (void (*notify)(void));
+uint32_t FLEXCAN0_tx_occupancy (void);
+uint32_t FLEXCAN0_get_time (void);
+uint32_t FLEXCAN0_get_tx_time (uint8_t mailbox, uint32_t *timestamp);
 
 #endif /* FLEXCAN_H_ */
@@ -0,0 +1,157 @@
+#include <stddef.h>
+#include <string.h>
+#include "benchmark.h"
+
+static const bench_port_t *s_port = NULL;
+static bench_stats_t *s_stats = NULL;
+
+static uint32_t s_seq = 0;          // Sequence number of the frame in flight
+static bool s_outstanding = false;  // A ping is waiting for its echo
+static uint8_t s_handle = 0;        // Port handle of the frame in flight
+static uint32_t s_sent_at = 0;      // Software send time, fallback for the TX stamp
+
+/*
+ * Sequence number is carried big-endian in bytes 0..3, byte 4 is BENCH_MAGIC.
+ */
+static void BENCH_BuildFrame(uint8_t *frame, uint32_t seq) {
+    memset(frame, 0, BENCH_FRAME_LEN);
+    frame[0] = (uint8_t)(seq >> 24);
+    frame[1] = (uint8_t)(seq >> 16);
+    frame[2] = (uint8_t)(seq >> 8);
+    frame[3] = (uint8_t)seq;
+    frame[4] = BENCH_MAGIC;
+}
+
+static bool BENCH_ParseFrame(const uint8_t *frame, uint32_t length, uint32_t *seq) {
+    if ((length < 5U) || (frame[4] != BENCH_MAGIC)) {
+        return false;
+    }
+    *seq = ((uint32_t)frame[0] << 24) | ((uint32_t)frame[1] << 16) |
+           ((uint32_t)frame[2] << 8) | (uint32_t)frame[3];
+    return true;
+}
+
+static void BENCH_Record(uint32_t rtt, uint32_t now) {
+    uint32_t bucket = rtt / BENCH_BUCKET_TICKS;
+
+    if (bucket >= BENCH_HIST_BUCKETS) {
+        bucket = BENCH_HIST_BUCKETS - 1U;
+    }
+    s_stats->hist[bucket]++;
+    if ((s_stats->matched == 0U) || (rtt < s_stats->rtt_min)) {
+        s_stats->rtt_min = rtt;
+    }
+    if (rtt > s_stats->rtt_max) {
+        s_stats->rtt_max = rtt;
+    }
+    s_stats->rtt_sum += rtt;
+    s_stats->matched++;
+    s_stats->last_time = now;
+}
+
+/**
+ * Start a new benchmark run.
+ *
+ * @param port  Bus access functions.
+ * @param stats Statistics to fill, cleared here.
+ */
+void BENCH_Init(const bench_port_t *port, bench_stats_t *stats) {
+    s_port = port;
+    s_stats = stats;
+    memset(stats, 0, sizeof(*stats));
+    stats->start_time = port->now();
+    stats->last_time = stats->start_time;
+    s_seq = 0;
+    s_outstanding = false;
+}
+
+/**
+ * Advance the ping-pong state machine; call from the main loop.
+ * Sends the next ping when none is in flight, matches echoes and expires
+ * pings whose echo did not arrive within BENCH_TIMEOUT_TICKS.
+ */
+void BENCH_Step(void) {
+    uint8_t frame[BENCH_FRAME_LEN];
+    uint32_t length;
+    uint32_t rx_time;
+    uint32_t now;
+
+    if (!s_outstanding) {
+        BENCH_BuildFrame(frame, s_seq);
+        if (s_port->send(frame, BENCH_FRAME_LEN, &s_handle)) {
+            s_sent_at = s_port->now();
+            s_outstanding = true;
+            s_stats->sent++;
+        }
+        return;
+    }
+
+    length = s_port->receive(frame, &rx_time);
+    if (length != 0U) {
+        uint32_t seq;
+
+        if (BENCH_ParseFrame(frame, length, &seq) && (seq == s_seq)) {
+            uint32_t tx_time;
+
+            if (!s_port->tx_time(s_handle, &tx_time)) {
+                tx_time = s_sent_at;
+            }
+            BENCH_Record(rx_time - tx_time, rx_time);
+            s_outstanding = false;
+            s_seq++;
+        } else {
+            s_stats->unexpected++;
+        }
+        return;
+    }
+
+    now = s_port->now();
+    if ((now - s_sent_at) > BENCH_TIMEOUT_TICKS) {
+        s_stats->lost++;
+        s_outstanding = false;
+        s_seq++;
+    }
+}
+
+/**
+ * @return Mean round-trip time in ticks.
+ */
+uint32_t BENCH_RttAvg(const bench_stats_t *stats) {
+    return (stats->matched != 0U) ? (uint32_t)(stats->rtt_sum / stats->matched) : 0U;
+}
+
+/**
+ * @return Upper edge (ticks) of the histogram bucket holding the 99th
+ *         percentile, at most rtt_max; rtt_max if it falls in the overflow
+ *         bucket.
+ */
+uint32_t BENCH_RttP99(const bench_stats_t *stats) {
+    uint32_t target = stats->matched - (stats->matched / 100U);
+    uint32_t seen = 0;
+    uint32_t i;
+
+    if (stats->matched == 0U) {
+        return 0U;
+    }
+    for (i = 0; i < (BENCH_HIST_BUCKETS - 1U); i++) {
+        seen += stats->hist[i];
+        if (seen >= target) {
+            uint32_t edge = (i + 1U) * BENCH_BUCKET_TICKS;
+
+            return (edge < stats->rtt_max) ? edge : stats->rtt_max;
+        }
+    }
+    return stats->rtt_max;
+}
+
+/**
+ * @return Completed round trips per second over the run so far.
+ */
+uint32_t BENCH_FramesPerSecond(const bench_stats_t *stats, uint32_t timer_hz) {
+    uint32_t elapsed = stats->last_time - stats->start_time;
+
+    if (elapsed == 0U) {
+        return 0U;
+    }
+    return (uint32_t)(((uint64_t)stats->matched * timer_hz) / elapsed);
+}
@@ -0,0 +1,60 @@
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Ping-pong round-trip benchmark.
+ *
+ * The transmitter sends sequence-numbered frames one at a time, the
+ * receiver echoes each frame unchanged, and every matching echo adds one
+ * round-trip time to the statistics. The engine only talks to the bus
+ * through bench_port_t, so the same code runs against FlexCAN on the EVB
+ * or against a simulated bus on a host.
+ */
+
+#define BENCH_FRAME_LEN      (8U)      // Bytes per ping frame
+#define BENCH_MAGIC          (0xB5U)   // Byte 4 of every ping frame
+#define BENCH_HIST_BUCKETS   (64U)     // Last bucket collects everything above range
+#define BENCH_BUCKET_TICKS   (4UL)     // Histogram resolution in timer ticks
+#define BENCH_TIMEOUT_TICKS  (50000UL) // Echo considered lost after this many ticks
+
+/**
+ * Bus access used by the benchmark; time is in the port's timer ticks.
+ */
+typedef struct {
+    /* Queue a frame, return false if no TX buffer is free. handle identifies it for tx_time. */
+    bool (*send)(const uint8_t *data, uint8_t length, uint8_t *handle);
+    /* Fetch a received frame, return its length (0 if none) and RX timestamp. */
+    uint32_t (*receive)(uint8_t *data, uint32_t *timestamp);
+    /* Hardware TX timestamp of a sent frame, false while still pending. */
+    bool (*tx_time)(uint8_t handle, uint32_t *timestamp);
+    /* Current time. */
+    uint32_t (*now)(void);
+} bench_port_t;
+
+/**
+ * Round-trip statistics, kept in RAM for the debugger.
+ */
+typedef struct {
+    uint32_t sent;
+    uint32_t matched;
+    uint32_t lost;        /* No echo within BENCH_TIMEOUT_TICKS */
+    uint32_t unexpected;  /* Echo with a stale or unknown sequence number */
+    uint32_t rtt_min;
+    uint32_t rtt_max;
+    uint64_t rtt_sum;
+    uint32_t start_time;
+    uint32_t last_time;
+    uint32_t hist[BENCH_HIST_BUCKETS];
+} bench_stats_t;
+
+void BENCH_Init(const bench_port_t *port, bench_stats_t *stats);
+void BENCH_Step(void);
+
+uint32_t BENCH_RttAvg(const bench_stats_t *stats);
+uint32_t BENCH_RttP99(const bench_stats_t *stats);
+uint32_t BENCH_FramesPerSecond(const bench_stats_t *stats, uint32_t timer_hz);
+
+#endif /* BENCHMARK_H_ */
@@ -0,0 +1,210 @@
+#ifndef CAN_TIMING_H_
+#define CAN_TIMING_H_
+
+/*
+ * Compile-time FlexCAN bit-timing solver.
+ *
+ * Every macro is an integer constant expression of the protocol clock
+ * (clk, Hz), the bitrate (br, bit/s) and the requested sample point (sp,
+ * percent), so register values are folded by the compiler and
+ * CAN_TIMING_CHECK() rejects unreachable timings at build time.
+ *
+ * Nominal phase (CTRL1 and CBT): the first time quanta count of
+ * CAN_TIMING_TQ() that divides the clock exactly with a prescaler <= 256
+ * and whose segments fit the fields and land within 5 % of the requested
+ * sample point.
+ * Segments: PSEG2 follows the sample point (2..8 Tq), PSEG1 = PSEG2 while
+ * PROPSEG fits in 8 Tq, RJW = min(4, PSEG1, PSEG2).
+ *
+ * Data phase (FDCBT): same rules with the FD field limits, the
+ * propagation segment takes what PSEG1 cannot.
+ */
+
+#define CAN_TIMING_MIN(a, b)  (((a) < (b)) ? (a) : (b))
+#define CAN_TIMING_MAX(a, b)  (((a) > (b)) ? (a) : (b))
+
+/* ----------------------------------------------------------------------
+ * Nominal phase
+ * -------------------------------------------------------------------- */
+
+/* PSEG2 of a bit of tq quanta: follows the sample point, 2..8 Tq */
+#define CAN_TIMING_TQ_PSEG2(tq, sp) \
+    CAN_TIMING_MIN(8UL, CAN_TIMING_MAX(2UL, (((tq) * (100UL - (sp))) + 50UL) / 100UL))
+
+/* PROPSEG + PSEG1 of a bit of tq quanta */
+#define CAN_TIMING_TQ_TSEG1(tq, sp) \
+    ((tq) - 1UL - CAN_TIMING_TQ_PSEG2(tq, sp))
+
+/* Sample point within 5 % of the request */
+#define CAN_TIMING_SP_OK(actual, sp) \
+    ((((actual) + 5UL) >= (sp)) && ((actual) <= ((sp) + 5UL)))
+
+/* tq quanta per bit give an exact bitrate with a prescaler of 1..256, the
+ * rest of the bit splits into PSEG1 (PSEG2..8) and PROPSEG (1..8), and the
+ * sample point is close enough */
+#define CAN_TIMING_FITS(clk, br, sp, tq) \
+    ((((clk) % ((br) * (tq))) == 0UL) && (((clk) / ((br) * (tq))) >= 1UL) && \
+     (((clk) / ((br) * (tq))) <= 256UL) && \
+     (CAN_TIMING_TQ_TSEG1(tq, sp) <= 16UL) && \
+     (CAN_TIMING_TQ_TSEG1(tq, sp) > CAN_TIMING_TQ_PSEG2(tq, sp)) && \
+     CAN_TIMING_SP_OK(((1UL + CAN_TIMING_TQ_TSEG1(tq, sp)) * 100UL) / (tq), sp))
+
+/* Per-bit-length segments; CAN_TIMING_SELECT() evaluates them for the
+ * chosen quanta count so the candidate search is expanded once per field */
+#define CAN_TIMING_TQ_TQ(tq, sp)  (tq)
+
+#define CAN_TIMING_TQ_PSEG1(tq, sp) \
+    CAN_TIMING_MAX(CAN_TIMING_TQ_PSEG2(tq, sp), \
+        ((CAN_TIMING_TQ_TSEG1(tq, sp) > 8UL) ? (CAN_TIMING_TQ_TSEG1(tq, sp) - 8UL) : 0UL))
+
+#define CAN_TIMING_TQ_PROPSEG(tq, sp) \
+    (CAN_TIMING_TQ_TSEG1(tq, sp) - CAN_TIMING_TQ_PSEG1(tq, sp))
+
+#define CAN_TIMING_TQ_RJW(tq, sp) \
+    CAN_TIMING_MIN(4UL, CAN_TIMING_MIN(CAN_TIMING_TQ_PSEG1(tq, sp), CAN_TIMING_TQ_PSEG2(tq, sp)))
+
+#define CAN_TIMING_TQ_SP(tq, sp) \
+    (((1UL + CAN_TIMING_TQ_TSEG1(tq, sp)) * 100UL) / (tq))
+
+/* f(tq, sp) for the first fitting quanta count, preferred counts first;
+ * 0 when no candidate fits */
+#define CAN_TIMING_SELECT(clk, br, sp, f) \
+    (CAN_TIMING_FITS(clk, br, sp, 16UL) ? f(16UL, sp) : \
+     CAN_TIMING_FITS(clk, br, sp, 20UL) ? f(20UL, sp) : \
+     CAN_TIMING_FITS(clk, br, sp, 10UL) ? f(10UL, sp) : \
+     CAN_TIMING_FITS(clk, br, sp,  8UL) ? f( 8UL, sp) : \
+     CAN_TIMING_FITS(clk, br, sp, 25UL) ? f(25UL, sp) : \
+     CAN_TIMING_FITS(clk, br, sp, 24UL) ? f(24UL, sp) : \
+     CAN_TIMING_FITS(clk, br, sp, 12UL) ? f(12UL, sp) : \
+     CAN_TIMING_FITS(clk, br, sp, 18UL) ? f(18UL, sp) : \
+     CAN_TIMING_FITS(clk, br, sp, 14UL) ? f(14UL, sp) : \
+     CAN_TIMING_FITS(clk, br, sp, 15UL) ? f(15UL, sp) : \
+     CAN_TIMING_FITS(clk, br, sp, 22UL) ? f(22UL, sp) : \
+     CAN_TIMING_FITS(clk, br, sp,  9UL) ? f( 9UL, sp) : 0UL)
+
+#define CAN_TIMING_TQ(clk, br, sp) \
+    CAN_TIMING_SELECT(clk, br, sp, CAN_TIMING_TQ_TQ)
+
+#define CAN_TIMING_PRESC(clk, br, sp) \
+    ((clk) / ((br) * CAN_TIMING_MAX(CAN_TIMING_TQ(clk, br, sp), 1UL)))
+
+#define CAN_TIMING_PSEG2(clk, br, sp) \
+    CAN_TIMING_SELECT(clk, br, sp, CAN_TIMING_TQ_PSEG2)
+
+/* PROPSEG + PSEG1 */
+#define CAN_TIMING_TSEG1(clk, br, sp) \
+    CAN_TIMING_SELECT(clk, br, sp, CAN_TIMING_TQ_TSEG1)
+
+#define CAN_TIMING_PSEG1(clk, br, sp) \
+    CAN_TIMING_SELECT(clk, br, sp, CAN_TIMING_TQ_PSEG1)
+
+#define CAN_TIMING_PROPSEG(clk, br, sp) \
+    CAN_TIMING_SELECT(clk, br, sp, CAN_TIMING_TQ_PROPSEG)
+
+#define CAN_TIMING_RJW(clk, br, sp) \
+    CAN_TIMING_SELECT(clk, br, sp, CAN_TIMING_TQ_RJW)
+
+/* Achieved sample point in percent */
+#define CAN_TIMING_SP_ACTUAL(clk, br, sp) \
+    CAN_TIMING_SELECT(clk, br, sp, CAN_TIMING_TQ_SP)
+
+/* CTRL1 bit timing fields; src: 0 = oscillator clock, 1 = bus clock */
+#define CAN_TIMING_CTRL1(src, clk, br, sp) \
+    (CAN_CTRL1_PRESDIV(CAN_TIMING_PRESC(clk, br, sp) - 1UL) | \
+     CAN_CTRL1_RJW(CAN_TIMING_RJW(clk, br, sp) - 1UL) | \
+     CAN_CTRL1_PSEG1(CAN_TIMING_PSEG1(clk, br, sp) - 1UL) | \
+     CAN_CTRL1_PSEG2(CAN_TIMING_PSEG2(clk, br, sp) - 1UL) | \
+     CAN_CTRL1_PROPSEG(CAN_TIMING_PROPSEG(clk, br, sp) - 1UL) | \
+     CAN_CTRL1_CLKSRC(src))
+
+/* Same nominal timing through CBT (required when CAN FD is enabled) */
+#define CAN_TIMING_CBT(clk, br, sp) \
+    (CAN_CBT_BTF_MASK | \
+     CAN_CBT_EPRESDIV(CAN_TIMING_PRESC(clk, br, sp) - 1UL) | \
+     CAN_CBT_ERJW(CAN_TIMING_RJW(clk, br, sp) - 1UL) | \
+     CAN_CBT_EPROPSEG(CAN_TIMING_PROPSEG(clk, br, sp) - 1UL) | \
+     CAN_CBT_EPSEG1(CAN_TIMING_PSEG1(clk, br, sp) - 1UL) | \
+     CAN_CBT_EPSEG2(CAN_TIMING_PSEG2(clk, br, sp) - 1UL))
+
+/* ----------------------------------------------------------------------
+ * CAN FD data phase
+ * -------------------------------------------------------------------- */
+
+#define CAN_TIMING_FD_FITS(clk, br, tq) \
+    ((((clk) % ((br) * (tq))) == 0UL) && (((clk) / ((br) * (tq))) >= 1UL) && \
+     (((clk) / ((br) * (tq))) <= 1024UL))
+
+#define CAN_TIMING_FD_TQ(clk, br) \
+    (CAN_TIMING_FD_FITS(clk, br, 10UL) ? 10UL : \
+     CAN_TIMING_FD_FITS(clk, br,  8UL) ?  8UL : \
+     CAN_TIMING_FD_FITS(clk, br, 16UL) ? 16UL : \
+     CAN_TIMING_FD_FITS(clk, br, 20UL) ? 20UL : \
+     CAN_TIMING_FD_FITS(clk, br, 12UL) ? 12UL : \
+     CAN_TIMING_FD_FITS(clk, br, 24UL) ? 24UL : \
+     CAN_TIMING_FD_FITS(clk, br,  6UL) ?  6UL : \
+     CAN_TIMING_FD_FITS(clk, br,  5UL) ?  5UL : 0UL)
+
+#define CAN_TIMING_FD_PRESC(clk, br) \
+    ((clk) / ((br) * CAN_TIMING_MAX(CAN_TIMING_FD_TQ(clk, br), 1UL)))
+
+#define CAN_TIMING_FD_PSEG2(clk, br, sp) \
+    CAN_TIMING_MIN(8UL, CAN_TIMING_MAX(2UL, \
+        ((CAN_TIMING_FD_TQ(clk, br) * (100UL - (sp))) + 50UL) / 100UL))
+
+#define CAN_TIMING_FD_TSEG1(clk, br, sp) \
+    (CAN_TIMING_FD_TQ(clk, br) - 1UL - CAN_TIMING_FD_PSEG2(clk, br, sp))
+
+#define CAN_TIMING_FD_PSEG1(clk, br, sp) \
+    CAN_TIMING_MIN(CAN_TIMING_FD_TSEG1(clk, br, sp), CAN_TIMING_FD_PSEG2(clk, br, sp))
+
+/* FPROPSEG is programmed as the quanta count itself (0..31) */
+#define CAN_TIMING_FD_PROPSEG(clk, br, sp) \
+    (CAN_TIMING_FD_TSEG1(clk, br, sp) - CAN_TIMING_FD_PSEG1(clk, br, sp))
+
+#define CAN_TIMING_FD_RJW(clk, br, sp) \
+    CAN_TIMING_MIN(CAN_TIMING_FD_PSEG1(clk, br, sp), CAN_TIMING_FD_PSEG2(clk, br, sp))
+
+#define CAN_TIMING_FD_SP_ACTUAL(clk, br, sp) \
+    (((1UL + CAN_TIMING_FD_TSEG1(clk, br, sp)) * 100UL) / CAN_TIMING_MAX(CAN_TIMING_FD_TQ(clk, br), 1UL))
+
+#define CAN_TIMING_FDCBT(clk, br, sp) \
+    (CAN_FDCBT_FPRESDIV(CAN_TIMING_FD_PRESC(clk, br) - 1UL) | \
+     CAN_FDCBT_FRJW(CAN_TIMING_FD_RJW(clk, br, sp) - 1UL) | \
+     CAN_FDCBT_FPROPSEG(CAN_TIMING_FD_PROPSEG(clk, br, sp)) | \
+     CAN_FDCBT_FPSEG1(CAN_TIMING_FD_PSEG1(clk, br, sp) - 1UL) | \
+     CAN_FDCBT_FPSEG2(CAN_TIMING_FD_PSEG2(clk, br, sp) - 1UL))
+
+/* ----------------------------------------------------------------------
+ * Build-time checks
+ * -------------------------------------------------------------------- */
+
+/*
+ * Oscillator tolerance (ISO 11898-1), tol in ppm:
+ *   df <= RJW / (20 * TQ)
+ *   df <= min(PSEG1, PSEG2) / (2 * (13 * TQ - PSEG2))
+ */
+#define CAN_TIMING_TOL_OK(tq, pseg1, pseg2, rjw, tol) \
+    ((((tol) * 20UL * (tq)) <= ((rjw) * 1000000UL)) && \
+     (((tol) * 2UL * ((13UL * (tq)) - (pseg2))) <= (CAN_TIMING_MIN(pseg1, pseg2) * 1000000UL)))
+
+#define CAN_TIMING_CHECK(clk, br, sp, tol) \
+    _Static_assert(CAN_TIMING_TQ(clk, br, sp) != 0UL, \
+                   "CAN bitrate and sample point not reachable from this clock"); \
+    _Static_assert((CAN_TIMING_PROPSEG(clk, br, sp) >= 1UL) && (CAN_TIMING_PROPSEG(clk, br, sp) <= 8UL) && \
+                   (CAN_TIMING_PSEG1(clk, br, sp) <= 8UL), \
+                   "CAN nominal segments out of range"); \
+    _Static_assert(CAN_TIMING_SP_OK(CAN_TIMING_SP_ACTUAL(clk, br, sp), sp), \
+                   "CAN nominal sample point out of tolerance"); \
+    _Static_assert(CAN_TIMING_TOL_OK(CAN_TIMING_TQ(clk, br, sp), CAN_TIMING_PSEG1(clk, br, sp), \
+                                     CAN_TIMING_PSEG2(clk, br, sp), CAN_TIMING_RJW(clk, br, sp), tol), \
+                   "CAN nominal timing does not cover the oscillator tolerance")
+
+#define CAN_TIMING_FD_CHECK(clk, br, sp) \
+    _Static_assert(CAN_TIMING_FD_TQ(clk, br) != 0UL, \
+                   "CAN FD data bitrate not reachable from this clock"); \
+    _Static_assert((CAN_TIMING_FD_PSEG1(clk, br, sp) >= 1UL) && (CAN_TIMING_FD_PROPSEG(clk, br, sp) <= 31UL), \
+                   "CAN FD data segments out of range"); \
+    _Static_assert(CAN_TIMING_SP_OK(CAN_TIMING_FD_SP_ACTUAL(clk, br, sp), sp), \
+                   "CAN FD data sample point out of tolerance")
+
+#endif /* CAN_TIMING_H_ */
@@ -0,0 +1,131 @@
+#include <stddef.h>
+#include "S32K144.h"
+#include <interrupt_manager.h>
+#include "capture.h"
+
+#define CAPTURE_CHANNEL_COUNT  (8U)
+/* A capture may look up to this many ticks newer than the estimate of "now"
+ * because of the microsecond granularity of TIMEBASE */
+#define CAPTURE_SLACK          (64U)
+
+static const IRQn_Type s_irq[CAPTURE_CHANNEL_COUNT / 2U] = {
+    FTM3_Ch0_Ch1_IRQn, FTM3_Ch2_Ch3_IRQn, FTM3_Ch4_Ch5_IRQn, FTM3_Ch6_Ch7_IRQn
+};
+
+static capture_callback_t s_callback = NULL;
+static uint32_t s_channels = 0;
+static uint64_t s_offset = 0;  // TIMEBASE ticks minus FTM3 counter, fixed at init
+
+/*
+ * Full 64-bit time of a 16-bit counter value from the last 8 ms.
+ */
+static uint64_t CAPTURE_Extend(uint16_t count)
+{
+    uint64_t est = (TIMEBASE_NowUs() * CAPTURE_TICKS_PER_US) - s_offset;
+    uint64_t ticks = (est & ~(uint64_t)0xFFFFU) | count;
+
+    if (ticks > (est + CAPTURE_SLACK)) {
+        ticks -= 0x10000U;  // Latched before the last counter wrap
+    }
+    return ticks + s_offset;
+}
+
+/**
+ * Start FTM3 and put the channels in channelMask in capture mode (both
+ * edges), disarmed. The pins must be muxed to FTM3 and TIMEBASE running.
+ */
+void CAPTURE_Init(uint32_t channelMask, capture_callback_t callback)
+{
+    uint32_t ch;
+
+    s_callback = callback;
+    s_channels = channelMask & 0xFFU;
+
+    PCC->PCCn[PCC_FTM3_INDEX] |= PCC_PCCn_CGC_MASK;
+    FTM3->MODE |= FTM_MODE_WPDIS_MASK;
+    FTM3->SC = 0;
+    FTM3->CNTIN = 0;
+    FTM3->MOD = 0xFFFFU;
+    FTM3->CNT = 0;
+    for (ch = 0; ch < CAPTURE_CHANNEL_COUNT; ch++) {
+        if ((s_channels & (1UL << ch)) != 0U) {
+            FTM3->CONTROLS[ch].CnSC = 0;  // Input capture, disarmed
+            INT_SYS_EnableIRQ(s_irq[ch / 2U]);
+        }
+    }
+    // External clock = PCC functional clock of FTM3
+    FTM3->SC = FTM_SC_CLKS(3) | FTM_SC_PS(0);
+
+    INT_SYS_DisableIRQGlobal();
+    s_offset = (TIMEBASE_NowUs() * CAPTURE_TICKS_PER_US) - FTM3->CNT;
+    INT_SYS_EnableIRQGlobal();
+}
+
+/**
+ * Capture the next edge of the channel (and raise the interrupt for it).
+ */
+void CAPTURE_Arm(uint32_t channel)
+{
+    // Read then write 0 clears a stale CHF
+    (void)FTM3->CONTROLS[channel].CnSC;
+    FTM3->CONTROLS[channel].CnSC = 0;
+    FTM3->CONTROLS[channel].CnSC = FTM_CnSC_ELSA_MASK | FTM_CnSC_ELSB_MASK | FTM_CnSC_CHIE_MASK;
+}
+
+/**
+ * Ignore edges; the last captured value stays in CnV.
+ */
+void CAPTURE_Disarm(uint32_t channel)
+{
+    FTM3->CONTROLS[channel].CnSC = 0;
+}
+
+/**
+ * Current time in ticks, same scale as the callback timestamps.
+ */
+uint64_t CAPTURE_NowTicks(void)
+{
+    return CAPTURE_Extend((uint16_t)FTM3->CNT);
+}
+
+/*
+ * Disarm before reporting so bounce edges after the first one are not
+ * captured; the callback re-arms when it wants the next edge.
+ */
+static void CAPTURE_IrqHandler(uint32_t first)
+{
+    uint32_t ch;
+
+    for (ch = first; ch < (first + 2U); ch++) {
+        if (((s_channels & (1UL << ch)) != 0U) &&
+            ((FTM3->CONTROLS[ch].CnSC & (FTM_CnSC_CHF_MASK | FTM_CnSC_CHIE_MASK)) ==
+             (FTM_CnSC_CHF_MASK | FTM_CnSC_CHIE_MASK))) {
+            uint16_t count = (uint16_t)FTM3->CONTROLS[ch].CnV;
+
+            CAPTURE_Disarm(ch);
+            if (s_callback != NULL) {
+                s_callback(ch, CAPTURE_Extend(count));
+            }
+        }
+    }
+}
+
+void FTM3_Ch0_Ch1_IRQHandler(void)
+{
+    CAPTURE_IrqHandler(0U);
+}
+
+void FTM3_Ch2_Ch3_IRQHandler(void)
+{
+    CAPTURE_IrqHandler(2U);
+}
+
+void FTM3_Ch4_Ch5_IRQHandler(void)
+{
+    CAPTURE_IrqHandler(4U);
+}
+
+void FTM3_Ch6_Ch7_IRQHandler(void)
+{
+    CAPTURE_IrqHandler(6U);
+}
@@ -0,0 +1,38 @@
+#ifndef CAPTURE_H_
+#define CAPTURE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "timebase.h"
+
+/*
+ * Edge timestamps by FTM3 input capture.
+ *
+ * FTM3 counts its 8 MHz functional clock (SIRC_DIV1) free-running; a channel
+ * in capture mode latches the counter on each edge of its pin, so the time
+ * is exact to one tick (125 ns) whatever the interrupt latency. The 16-bit
+ * capture is extended to 64 bits against TIMEBASE, which runs from the same
+ * oscillator (SIRC_DIV2): timestamps are TIMEBASE microseconds times
+ * CAPTURE_TICKS_PER_US and are consistent with TIMEBASE_NowUs().
+ *
+ * Extension is done in the capture interrupt and assumes the interrupt runs
+ * within one counter wrap (8 ms) of the edge.
+ */
+
+#define CAPTURE_CLK_HZ        (8000000UL) // FTM3 functional clock
+#define CAPTURE_TICKS_PER_US  (CAPTURE_CLK_HZ / 1000000UL)
+
+#if CAPTURE_CLK_HZ != TIMEBASE_CLK_HZ
+#error "FTM3 and LPIT0 must run from the same clock for the timestamp extension"
+#endif
+
+/* Called from the FTM3 channel interrupt with the edge time in ticks.
+ * The channel is disarmed first, see CAPTURE_Arm(). */
+typedef void (*capture_callback_t)(uint32_t channel, uint64_t ticks);
+
+void CAPTURE_Init(uint32_t channelMask, capture_callback_t callback);
+void CAPTURE_Arm(uint32_t channel);
+void CAPTURE_Disarm(uint32_t channel);
+uint64_t CAPTURE_NowTicks(void);
+
+#endif /* CAPTURE_H_ */
@@ -0,0 +1,103 @@
+#ifndef CMD_PROTOCOL_H_
+#define CMD_PROTOCOL_H_
+
+#include <stdint.h>
+
+/*
+ * Command frames from Can_Transmit to Can_Receive (same file in both projects).
+ *
+ * A frame carries commands back to back: an opcode byte followed by the
+ * fixed number of argument bytes of that opcode (CMD_LEN_*). CMD_OP_END or
+ * the end of the payload ends the list, so zero padding is harmless. The
+ * same format fills an 8-byte classic or a 64-byte FD payload.
+ *
+ * Multi-byte arguments are big-endian. A mask selects channels of the
+ * receiver's PWM instance, bit n = channel n. Duty and period are in FTM
+ * ticks, ramp lengths in PWM periods.
+ */
+
+#define CMD_OP_END           (0x00U) // -
+#define CMD_OP_SET_MODE      (0x01U) // mode: 0-3 brightness step, 4 breathing
+#define CMD_OP_SET_DUTY      (0x02U) // mask, duty[2]
+#define CMD_OP_RAMP_TO       (0x03U) // mask, duty[2], periods[2]
+#define CMD_OP_SET_LEVEL     (0x04U) // mask, level (0-255, through the channel's curve)
+#define CMD_OP_SET_CURVE     (0x05U) // mask, curve (brightness_curve_t)
+#define CMD_OP_SET_PERIOD    (0x06U) // mod[2] (period - 1)
+#define CMD_OP_QUERY_STATUS  (0x07U) // -, the frame is answered with CMD_OP_STATUS instead of its echo
+#define CMD_OP_COUNT         (0x08U)
+
+/* Reply, receiver to transmitter */
+#define CMD_OP_STATUS        (0x80U) // mod[2], ramp mask, waveform playing, rejected[2]
+
+/* Argument bytes after the opcode */
+#define CMD_LEN_END          (0U)
+#define CMD_LEN_SET_MODE     (1U)
+#define CMD_LEN_SET_DUTY     (3U)
+#define CMD_LEN_RAMP_TO      (5U)
+#define CMD_LEN_SET_LEVEL    (2U)
+#define CMD_LEN_SET_CURVE    (2U)
+#define CMD_LEN_SET_PERIOD   (2U)
+#define CMD_LEN_QUERY_STATUS (0U)
+#define CMD_LEN_STATUS       (6U)
+
+#define CMD_GET16(p)         ((uint16_t)(((uint16_t)(p)[0] << 8) | (p)[1]))
+
+static inline uint8_t *CMD_Put16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)value;
+    return p + 2;
+}
+
+/* Encoders: write one command at p, return the position after it */
+
+static inline uint8_t *CMD_PutSetMode(uint8_t *p, uint8_t mode)
+{
+    p[0] = CMD_OP_SET_MODE;
+    p[1] = mode;
+    return p + 1U + CMD_LEN_SET_MODE;
+}
+
+static inline uint8_t *CMD_PutSetDuty(uint8_t *p, uint8_t mask, uint16_t duty)
+{
+    p[0] = CMD_OP_SET_DUTY;
+    p[1] = mask;
+    return CMD_Put16(&p[2], duty);
+}
+
+static inline uint8_t *CMD_PutRampTo(uint8_t *p, uint8_t mask, uint16_t duty, uint16_t periods)
+{
+    p[0] = CMD_OP_RAMP_TO;
+    p[1] = mask;
+    return CMD_Put16(CMD_Put16(&p[2], duty), periods);
+}
+
+static inline uint8_t *CMD_PutSetLevel(uint8_t *p, uint8_t mask, uint8_t level)
+{
+    p[0] = CMD_OP_SET_LEVEL;
+    p[1] = mask;
+    p[2] = level;
+    return p + 1U + CMD_LEN_SET_LEVEL;
+}
+
+static inline uint8_t *CMD_PutSetCurve(uint8_t *p, uint8_t mask, uint8_t curve)
+{
+    p[0] = CMD_OP_SET_CURVE;
+    p[1] = mask;
+    p[2] = curve;
+    return p + 1U + CMD_LEN_SET_CURVE;
+}
+
+static inline uint8_t *CMD_PutSetPeriod(uint8_t *p, uint16_t mod)
+{
+    p[0] = CMD_OP_SET_PERIOD;
+    return CMD_Put16(&p[1], mod);
+}
+
+static inline uint8_t *CMD_PutQueryStatus(uint8_t *p)
+{
+    p[0] = CMD_OP_QUERY_STATUS;
+    return p + 1U + CMD_LEN_QUERY_STATUS;
+}
+
+#endif /* CMD_PROTOCOL_H_ */
@@ -0,0 +1,142 @@
+#include <stddef.h>
+#include "gesture.h"
+
+typedef enum {
+    ST_IDLE = 0,  // No button down, no sequence
+    ST_DOWN,      // Active button down, long-press timer running
+    ST_LONG,      // Long press reported, waiting for release
+    ST_UP,        // Released, multi-press window running
+    ST_CHORD,     // Both buttons down, waiting until all are released
+    ST_COUNT
+} gesture_state_t;
+
+typedef enum {
+    EV_DOWN_ACTIVE = 0,  // The button of the current sequence went down
+    EV_DOWN_OTHER,       // Any other button went down
+    EV_UP_PARTIAL,       // A button was released, another is still down
+    EV_UP_ALL,           // The last button down was released
+    EV_TIMEOUT
+} gesture_event_t;
+
+typedef void (*gesture_action_t)(void);
+
+typedef struct {
+    uint8_t state;
+    uint8_t event;
+    uint8_t next;
+    gesture_action_t action;
+} gesture_transition_t;
+
+static const gesture_port_t *s_port = NULL;
+static gesture_state_t s_state = ST_IDLE;
+static uint32_t s_down = 0;      // Bit n set while button n is down
+static uint32_t s_active = 0;    // Button of the current sequence
+static uint32_t s_button = 0;    // Button of the edge being handled
+static uint32_t s_count = 0;     // Presses in the current sequence
+
+static void ActFirst(void) {
+    if (s_count != 0U) {
+        s_port->emit(GESTURE_SEQUENCE_END, s_active, s_count);
+    }
+    s_active = s_button;
+    s_count = 1;
+    s_port->emit(GESTURE_PRESS, s_active, s_count);
+    s_port->start_timer(GESTURE_LONG_PRESS_MS);
+}
+
+static void ActAgain(void) {
+    s_count++;
+    s_port->emit(GESTURE_PRESS, s_active, s_count);
+    s_port->start_timer(GESTURE_LONG_PRESS_MS);
+}
+
+static void ActRelease(void) {
+    s_port->start_timer(GESTURE_MULTI_PRESS_MS);
+}
+
+static void ActLong(void) {
+    s_port->emit(GESTURE_LONG, s_active, s_count);
+}
+
+static void ActChord(void) {
+    s_port->stop_timer();
+    s_port->emit(GESTURE_CHORD, s_active, 0U);
+    s_count = 0;
+}
+
+static void ActEnd(void) {
+    s_port->emit(GESTURE_SEQUENCE_END, s_active, s_count);
+    s_count = 0;
+}
+
+static void ActReset(void) {
+    s_port->stop_timer();
+    s_count = 0;
+}
+
+/* Pairs not listed leave the state unchanged */
+static const gesture_transition_t s_table[] = {
+    { ST_IDLE,  EV_DOWN_OTHER,  ST_DOWN,  ActFirst   },
+    { ST_DOWN,  EV_UP_ALL,      ST_UP,    ActRelease },
+    { ST_DOWN,  EV_DOWN_OTHER,  ST_CHORD, ActChord   },
+    { ST_DOWN,  EV_TIMEOUT,     ST_LONG,  ActLong    },
+    { ST_LONG,  EV_UP_ALL,      ST_IDLE,  ActReset   },
+    { ST_LONG,  EV_DOWN_OTHER,  ST_CHORD, ActChord   },
+    { ST_UP,    EV_DOWN_ACTIVE, ST_DOWN,  ActAgain   },
+    { ST_UP,    EV_DOWN_OTHER,  ST_DOWN,  ActFirst   },
+    { ST_UP,    EV_TIMEOUT,     ST_IDLE,  ActEnd     },
+    { ST_CHORD, EV_UP_ALL,      ST_IDLE,  ActReset   },
+};
+
+static void GESTURE_Dispatch(gesture_event_t event) {
+    uint32_t i;
+
+    for (i = 0; i < (sizeof(s_table) / sizeof(s_table[0])); i++) {
+        if ((s_table[i].state == (uint8_t)s_state) && (s_table[i].event == (uint8_t)event)) {
+            s_state = (gesture_state_t)s_table[i].next;
+            s_table[i].action();
+            return;
+        }
+    }
+}
+
+/**
+ * Reset the recognizer.
+ */
+void GESTURE_Init(const gesture_port_t *port) {
+    s_port = port;
+    s_state = ST_IDLE;
+    s_down = 0;
+    s_active = 0;
+    s_count = 0;
+}
+
+/**
+ * Feed one debounced edge. Repeated edges with the same level are ignored.
+ *
+ * @param button  0..GESTURE_BUTTON_COUNT-1
+ * @param pressed true for press, false for release
+ */
+void GESTURE_Input(uint32_t button, bool pressed) {
+    uint32_t bit = 1UL << button;
+
+    if ((button >= GESTURE_BUTTON_COUNT) || (((s_down & bit) != 0U) == pressed)) {
+        return;
+    }
+    s_button = button;
+    if (pressed) {
+        s_down |= bit;
+        // With no sequence running every press starts one (EV_DOWN_OTHER)
+        GESTURE_Dispatch(((button == s_active) && (s_state != ST_IDLE)) ? EV_DOWN_ACTIVE : EV_DOWN_OTHER);
+    } else {
+        s_down &= ~bit;
+        GESTURE_Dispatch((s_down == 0U) ? EV_UP_ALL : EV_UP_PARTIAL);
+    }
+}
+
+/**
+ * Timeout started through gesture_port_t.start_timer expired.
+ */
+void GESTURE_Timeout(void) {
+    GESTURE_Dispatch(EV_TIMEOUT);
+}
@@ -0,0 +1,43 @@
+#ifndef GESTURE_H_
+#define GESTURE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Button gesture recognizer for two buttons.
+ *
+ * Fed with debounced press/release edges and timer expiries, it reports
+ * presses (with their count inside a multi-press sequence), long presses,
+ * the two-button chord and the end of a press sequence. The transitions
+ * are a table, the engine never touches hardware: timing goes through
+ * gesture_port_t, so it runs in task context and on a host alike.
+ */
+
+#define GESTURE_BUTTON_COUNT     (2U)
+#define GESTURE_MULTI_PRESS_MS   (500U)  // Next press within this continues a sequence
+#define GESTURE_LONG_PRESS_MS    (800U)  // Held this long: long press
+
+typedef enum {
+    GESTURE_PRESS = 0,     /* Button went down; count = position in the sequence (1, 2, ...) */
+    GESTURE_LONG,          /* Button held for GESTURE_LONG_PRESS_MS */
+    GESTURE_CHORD,         /* Second button pressed while the first is held */
+    GESTURE_SEQUENCE_END   /* No further press within GESTURE_MULTI_PRESS_MS; count = total */
+} gesture_t;
+
+/**
+ * Services used by the engine.
+ */
+typedef struct {
+    /* (Re)start the single timeout, GESTURE_Timeout() is called when it expires. */
+    void (*start_timer)(uint32_t ms);
+    void (*stop_timer)(void);
+    /* Report a recognized gesture of button (0-based). */
+    void (*emit)(gesture_t gesture, uint32_t button, uint32_t count);
+} gesture_port_t;
+
+void GESTURE_Init(const gesture_port_t *port);
+void GESTURE_Input(uint32_t button, bool pressed);
+void GESTURE_Timeout(void);
+
+#endif /* GESTURE_H_ */
@@ -3,8 +3,25 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <FlexCan.h>
+#include "benchmark.h"
+#include "scheduler.h"
+#include "timebase.h"
+#include "gesture.h"
+#include "capture.h"
+#include "cmd_protocol.h"
 #define EVB
 
+/* 1: build benchmark ping-pong do thoi gian khu hoi thay cho demo nut nhan
+ * (Can_Receive cung phai build voi BENCHMARK_PINGPONG) */
+#define BENCHMARK_PINGPONG  0
+
+/* 1: build bo tao tai bus thay cho demo nut nhan */
+#define LOAD_GENERATOR      0
+
+#if BENCHMARK_PINGPONG && LOAD_GENERATOR
+#error "Chi chon mot trong BENCHMARK_PINGPONG va LOAD_GENERATOR"
+#endif
+
 #ifdef EVB
     #define LED_PORT        PORTD
     #define GPIO_PORT       PTD
@@ -15,7 +32,8 @@
     #define BTN1_PIN        13U
     #define BTN2_PIN        12U
     #define BTN_PORT        PORTC
-    #define BTN_PORT_IRQn   PORTC_IRQn
+    #define BTN1_CAPTURE_CH 7U  // PTC13 ALT2 = FTM3_CH7
+    #define BTN2_CAPTURE_CH 6U  // PTC12 ALT2 = FTM3_CH6
 
 #else
     #define LED_PORT        PORTC
@@ -27,8 +45,8 @@
 
 
 
-uint8_t buffer[4] = {0};
-uint8_t buffer_rx[4] = {0};
+uint8_t buffer[FLEXCAN0_PAYLOAD_SIZE] = {0};
+uint8_t buffer_rx[FLEXCAN0_PAYLOAD_SIZE] = {0};
 uint32_t RxLENGTH = 0;
 typedef enum {
     LED0_CHANGE_REQUESTED = 0x00U,
@@ -37,71 +55,293 @@ typedef enum {
 
 uint8_t ledRequested = LED0_CHANGE_REQUESTED;
 
-volatile uint8_t speed = 0;
-volatile uint32_t last_valid_press_time_for_sequence = 0;
-volatile uint32_t last_raw_interrupt_time = 0; // Cho việc chống nhiễu (debounce)
+uint8_t speed = 0;
 
 // Hằng số 
-#define MULTI_PRESS_TIMEOUT_MS  500U // 0.5 giây
-#define DEBOUNCE_PERIOD_MS      50U  // 50 mili giây
+#define STATS_PERIOD_MS         1000U // Chu ky cap nhat g_sched_stats
+#define BTN_SETTLE_US           (20000UL) // Thoi gian cho nut on dinh sau canh dau tien
+/* Bo loc so cua PORTC (LPO_CLK 128 kHz): xung ngan hon 31 chu ky (~240 us)
+ * khong toi FTM3; moi canh den capture tre deu ~240 us nen khoang thoi gian
+ * giua cac canh khong doi, phan rung dai hon do BTN_SETTLE_US xu ly */
+#define BTN_FILTER_WIDTH        (31U)
+#define BTN_COUNT               (2U)
+
+/* Nguon su kien (moi ngat mot hang doi, chi so nho uu tien cao hon) */
+#define SRC_CAN     (0U)
+#define SRC_BUTTON  (1U)
+#define SRC_TIMER   (2U)
+
+/* Su kien cua scheduler */
+#define EVT_CAN_RX  (0U) // Co khung trong RX_MAILBOX
+#define EVT_BUTTON  (1U) // Nut da on dinh, arg = mask cac chan can doc lai
+#define EVT_RETRY   (2U) // Thu gui lai khung toc do
+#define EVT_STATS   (3U) // Cap nhat g_sched_stats
+#define EVT_GESTURE (4U) // Het thoi gian cua bo nhan dien cu chi
+
+/* Bo dinh thoi phan mem cua timebase */
+#define TIMER_RETRY   (0U)
+#define TIMER_STATS   (1U)
+#define TIMER_GESTURE (2U)
+#define TIMER_SETTLE  (3U)
+#define RETRY_DELAY_US  (1000UL) // Cho 1 ms khi tat ca bo dem truyen deu ban
+
+/* Thong ke scheduler (thoi gian ranh, do tre dieu phoi), xem bang debugger */
+sched_stats_t g_sched_stats;
 
-void LPIT0_Init(void)
+/* Callback cua timebase (trong ngat LPIT0 CH3): chi dang su kien */
+static void RetryTimerExpired(void)
 {
-    PCC->PCCn[PCC_LPIT_INDEX] |= PCC_PCCn_CGC_MASK; // Bật clock LPIT0
-    LPIT0->MCR = 0x00000001; // Enable module, debug mode run
+    (void)SCHED_Post(SRC_TIMER, EVT_RETRY, 0U);
+}
 
-    LPIT0->TMR[0].TVAL = 8000 - 1; // 8 MHz / 8000 = 1 kHz => 1 ms
-    LPIT0->TMR[0].TCTRL = 0x00000021; // Enable timer, periodic, interrupt enabled
+static void StatsTimerExpired(void)
+{
+    (void)SCHED_Post(SRC_TIMER, EVT_STATS, 0U);
+}
 
-    LPIT0->MIER = 0x00000001; // Enable interrupt channel 0
-    INT_SYS_EnableIRQ(LPIT0_Ch0_IRQn);
+static void GestureTimerExpired(void)
+{
+    (void)SCHED_Post(SRC_TIMER, EVT_GESTURE, 0U);
 }
 
+bool g_send_flag = false;
+uint8_t g_speed_value_to_send = 0;
+/* true: cac lan nhan tiep theo trong cua so thay khung trong g_speed_mailbox
+ * thay vi xep them khung moi */
+bool g_replace_pending = false;
+uint8_t g_speed_mailbox = 0;
+/* Che do hai nut (BTN1 + BTN2), danh cho che do ma hoa trong description.txt;
+ * chua co ma hoa, chi dao trang thai */
+bool g_chord_mode = false;
+
+static volatile uint32_t s_btn_settling = 0; // Chan dang cho on dinh (capture da tat)
+static uint32_t s_btn_level = 0;             // Muc da on dinh cua cac nut (1 = nhan)
+static const uint32_t s_btn_pin[BTN_COUNT] = { BTN1_PIN, BTN2_PIN };
+static const uint32_t s_btn_capture_ch[BTN_COUNT] = { BTN1_CAPTURE_CH, BTN2_CAPTURE_CH };
+/* Thoi diem canh dau tien cua dot rung hien tai (tick CAPTURE, 125 ns) */
+static volatile uint64_t s_btn_edge[BTN_COUNT];
+/* Moc thoi gian (us) cho cac bo dinh thoi bo nhan dien cu chi khoi dong:
+ * thoi diem canh that su, khong phai luc nut on dinh */
+static uint64_t s_gesture_ref_us = 0;
+
+/* Do tre tu canh nhan nut den khung phan hoi tu Can_Receive (us), xem bang debugger */
+uint32_t g_press_to_echo_us = 0;
+static uint64_t s_press_ticks = 0;
+static bool s_press_pending = false;
+
+/*
+ * Het BTN_SETTLE_US sau canh dau tien (trong ngat LPIT0 CH3).
+ */
+static void SettleTimerExpired(void)
+{
+    uint32_t pins = s_btn_settling;
+
+    s_btn_settling = 0;
+    (void)SCHED_Post(SRC_TIMER, EVT_BUTTON, pins);
+}
+
+/*
+ * Tat capture cua cac chan trong pins va cho BTN_SETTLE_US (goi voi ngat da
+ * khoa hoac trong ngat capture). ticks la thoi diem canh, chi giu canh dau
+ * tien cua dot rung.
+ */
+static void ButtonHold(uint32_t pins, uint64_t ticks)
+{
+    uint32_t i;
+
+    for (i = 0; i < BTN_COUNT; i++)
+    {
+        uint32_t bit = 1UL << s_btn_pin[i];
+
+        if ((pins & bit) != 0U)
+        {
+            CAPTURE_Disarm(s_btn_capture_ch[i]);
+            if ((s_btn_settling & bit) == 0U)
+            {
+                s_btn_edge[i] = ticks;
+            }
+        }
+    }
+    s_btn_settling |= pins;
+    TIMEBASE_StartIn(TIMER_SETTLE, BTN_SETTLE_US, SettleTimerExpired);
+}
 
-volatile uint32_t g_millis = 0;
+/*
+ * Canh cua nut, thoi diem do FTM3 chot trong phan cung (trong ngat FTM3).
+ * Kenh da bi tat nen phan rung con lai khong vao CPU; moi canh nhan/nha chi
+ * ton mot lan ngat.
+ */
+static void ButtonCaptured(uint32_t channel, uint64_t ticks)
+{
+    uint32_t i = (channel == BTN1_CAPTURE_CH) ? 0U : 1U;
+
+    ButtonHold(1UL << s_btn_pin[i], ticks);
+}
+
+/*
+ * Gui (hoac thay) khung lenh SET_MODE mang toc do; neu tat ca bo dem dang ban thi thu lai o tick sau.
+ * Gui ngay o lan nhan dau tien; cac lan nhan sau trong cua so
+ * GESTURE_MULTI_PRESS_MS huy va ghi de khung chua gui (hoac gui khung
+ * cap nhat ngay sau no), nen bus chi mang gia tri moi nhat.
+ */
+static void SpeedTask_Send(void)
+{
+    status_t status;
+    uint8_t tx_buf[1U + CMD_LEN_SET_MODE];
+
+    (void)CMD_PutSetMode(tx_buf, g_speed_value_to_send);
+
+    if (g_replace_pending)
+    {
+        status = FLEXCAN0_replace_msg(g_speed_mailbox, tx_buf, sizeof(tx_buf));
+    }
+    else
+    {
+        status = FLEXCAN0_transmit_msg(tx_buf, sizeof(tx_buf), &g_speed_mailbox);
+        g_replace_pending = (status == STATUS_SUCCESS);
+    }
+    g_send_flag = (status != STATUS_SUCCESS);
+    if (g_send_flag)
+    {
+        TIMEBASE_StartIn(TIMER_RETRY, RETRY_DELAY_US, RetryTimerExpired);
+    }
+}
+
+/*
+ * Cu chi cua nut (goi tu GESTURE_Input/GESTURE_Timeout trong main):
+ *   BTN1 nhan lan n trong chuoi: toc do n (1, 2, 3, 0, 1, ...), gui ngay,
+ *       cac lan sau thay khung truoc do
+ *   BTN1 giu lau hoac BTN2 nhan: dung (toc do 0)
+ *   BTN1 + BTN2: dao g_chord_mode
+ */
+static void SpeedTask_OnGesture(gesture_t gesture, uint32_t button, uint32_t count)
+{
+    if (gesture == GESTURE_CHORD)
+    {
+        g_chord_mode = !g_chord_mode;
+        return;
+    }
+    if ((gesture == GESTURE_PRESS) && (button == 0U))
+    {
+        speed = (uint8_t)(count % 4U);
+        g_replace_pending = g_replace_pending && (count > 1U);
+        PINS_DRV_TogglePins(GPIO_PORT, (1 << LED1));
+        s_press_ticks = s_btn_edge[0];
+        s_press_pending = true;
+    }
+    else if ((gesture == GESTURE_LONG) || ((gesture == GESTURE_PRESS) && (button == 1U)))
+    {
+        speed = 0;
+        g_replace_pending = false;
+    }
+    else
+    {
+        return;
+    }
+    g_speed_value_to_send = speed;
+    SpeedTask_Send();
+}
 
-void LPIT0_Ch0_IRQHandler(void)
+static void GestureStartTimer(uint32_t ms)
 {
-    LPIT0->MSR |= LPIT_MSR_TIF0_MASK; // Clear flag
-    g_millis++;
+    TIMEBASE_Start(TIMER_GESTURE, s_gesture_ref_us + (ms * 1000UL), GestureTimerExpired);
 }
 
-uint32_t Sys_GetMillis(void)
+static void GestureStopTimer(void)
 {
-    return g_millis;
+    TIMEBASE_Stop(TIMER_GESTURE);
 }
-volatile uint32_t current_time;
-volatile bool g_send_flag = false;
-volatile uint8_t g_speed_value_to_send = 0;
 
-void buttonISR(void)
+static const gesture_port_t s_gesture_port = {
+    GestureStartTimer, GestureStopTimer, SpeedTask_OnGesture
+};
+
+/*
+ * Cac chan trong pins da on dinh: doc muc, dua canh (kem thoi diem that cua
+ * no) vao bo nhan dien cu chi va bat lai capture. Neu muc doi ngay sau khi
+ * doc thi cho on dinh lan nua.
+ */
+static void ButtonTask_OnSettled(uint32_t pins)
 {
+    uint32_t level = (uint32_t)PINS_DRV_ReadPins(BTN_GPIO) & pins;
+    uint32_t i;
 
-    if ((PINS_DRV_GetPortIntFlag(BTN_PORT) & (1 << BTN1_PIN)) != 0)
+    for (i = 0; i < BTN_COUNT; i++)
     {
+        uint32_t bit = 1UL << s_btn_pin[i];
 
-        current_time = Sys_GetMillis();
-        if ((current_time - last_raw_interrupt_time) < DEBOUNCE_PERIOD_MS) {
-            PINS_DRV_ClearPinIntFlagCmd(BTN_PORT, BTN1_PIN);
-            return;
+        if ((pins & bit) != 0U)
+        {
+            s_gesture_ref_us = s_btn_edge[i] / CAPTURE_TICKS_PER_US;
+            GESTURE_Input(i, (level & bit) != 0U);
+            CAPTURE_Arm(s_btn_capture_ch[i]);
         }
-        last_raw_interrupt_time = current_time;
+    }
+    s_btn_level = (s_btn_level & ~pins) | level;
 
-        if ((speed == 0) | ((current_time - last_valid_press_time_for_sequence) < MULTI_PRESS_TIMEOUT_MS)) {
-            speed++;
-            PINS_DRV_TogglePins(GPIO_PORT, (1 << LED1));
-            if (speed > 3) {
-            	speed = 0;
-            }
+    // Canh xay ra giua luc doc va luc bat lai capture se khong duoc chot;
+    // thoi diem cua no chi biet gan dung
+    pins &= ((uint32_t)PINS_DRV_ReadPins(BTN_GPIO) ^ s_btn_level);
+    if (pins != 0U)
+    {
+        INT_SYS_DisableIRQGlobal();
+        ButtonHold(pins, CAPTURE_NowTicks());
+        INT_SYS_EnableIRQGlobal();
+    }
+}
+
+static void GestureTask_OnTimer(uint32_t arg)
+{
+    (void)arg;
+    s_gesture_ref_us = TIMEBASE_NowUs();
+    GESTURE_Timeout();
+}
+
+static void SpeedTask_OnRetry(uint32_t arg)
+{
+    (void)arg;
+    if (g_send_flag)
+    {
+        SpeedTask_Send();
+    }
+}
+
+/*
+ * Chup thong ke moi STATS_PERIOD_MS; lan thuc day nay cung giu cho bo dem
+ * chu ky DWT cua scheduler khong tran giua hai lan cap nhat.
+ */
+static void StatsTask_OnTimer(uint32_t arg)
+{
+    (void)arg;
+    SCHED_GetStats(&g_sched_stats);
+    TIMEBASE_StartIn(TIMER_STATS, STATS_PERIOD_MS * 1000UL, StatsTimerExpired);
+}
+
+/*
+ * Khung phan hoi tu Can_Receive: dao LED0 cho moi khung nhan duoc; khung dau
+ * tien sau mot lan nhan BTN1 cho do tre tu canh nhan (gom ca BTN_SETTLE_US).
+ */
+static void CanTask_OnRx(uint32_t arg)
+{
+    (void)arg;
+    while ((RxLENGTH = FLEXCAN0_receive_msg(buffer_rx, NULL)) != 0U)
+    {
+        PINS_DRV_TogglePins(GPIO_PORT, (1 << LED0));
+        // Khung tra loi CMD_OP_STATUS khong phai la echo
+        if (s_press_pending && (buffer_rx[0] != CMD_OP_STATUS))
+        {
+            g_press_to_echo_us = (uint32_t)((CAPTURE_NowTicks() - s_press_ticks) / CAPTURE_TICKS_PER_US);
+            s_press_pending = false;
         }
-        last_valid_press_time_for_sequence = current_time; // Cập nhật thời gian cho lần nhấn này
-        g_speed_value_to_send = speed;
-        g_send_flag = true;
-        // Xóa cờ ngắt cho nút đã được xử lý
-        PINS_DRV_ClearPinIntFlagCmd(BTN_PORT, BTN1_PIN);
     }
 }
 
+/* Goi trong ngat FlexCAN */
+static void CanRxNotify(void)
+{
+    (void)SCHED_Post(SRC_CAN, EVT_CAN_RX, 0U);
+}
+
 void BoardInit(void)
 {
     CLOCK_DRV_Init(&clockMan1_InitConfig0);
@@ -118,41 +358,128 @@ void GPIOInit(void)
 
 	    /* Set Output value LEDs */
 	    PINS_DRV_ClearPins(GPIO_PORT, (1 << LED1) | (1 << LED0));
-	/* Setup button pin */
-	    PINS_DRV_SetPinsDirection(BTN_GPIO, ~((1 << BTN1_PIN)));
-    /* Setup button pins interrupt */
-    PINS_DRV_SetPinIntSel(BTN_PORT, BTN1_PIN, PORT_INT_RISING_EDGE);
-    /* Install buttons ISR */
-    INT_SYS_InstallHandler(BTN_PORT_IRQn, &buttonISR, NULL);
-
-    /* Enable buttons interrupt */
-    INT_SYS_EnableIRQ(BTN_PORT_IRQn);
+	/* Setup button pins */
+	    PINS_DRV_SetPinsDirection(BTN_GPIO, ~((1 << BTN1_PIN) | (1 << BTN2_PIN)));
+    /* Digital glitch filter on both buttons (filter config only while all are disabled);
+     * it sits in the pin input path, so it also filters the ALT2 capture input */
+    const port_digital_filter_config_t btnFilter = { PORT_DIGITAL_FILTER_LPO_CLOCK, BTN_FILTER_WIDTH };
+    PINS_DRV_DisableDigitalFilter(BTN_PORT, BTN1_PIN);
+    PINS_DRV_DisableDigitalFilter(BTN_PORT, BTN2_PIN);
+    PINS_DRV_ConfigDigitalFilter(BTN_PORT, &btnFilter);
+    PINS_DRV_EnableDigitalFilter(BTN_PORT, BTN1_PIN);
+    PINS_DRV_EnableDigitalFilter(BTN_PORT, BTN2_PIN);
+    /* Buttons go to FTM3 input capture (PDIR still reads the level);
+     * TIMEBASE must already run */
+    PINS_DRV_SetMuxModeSel(BTN_PORT, BTN1_PIN, PORT_MUX_ALT2);
+    PINS_DRV_SetMuxModeSel(BTN_PORT, BTN2_PIN, PORT_MUX_ALT2);
+    CAPTURE_Init((1UL << BTN1_CAPTURE_CH) | (1UL << BTN2_CAPTURE_CH), ButtonCaptured);
+    /* Capture press and release */
+    CAPTURE_Arm(BTN1_CAPTURE_CH);
+    CAPTURE_Arm(BTN2_CAPTURE_CH);
 }
 
 
 volatile int exit_code = 0;
 
+#if LOAD_GENERATOR
+/* Cau hinh tai: ID va do dai payload dung lan luot xoay vong, moi khung moi
+ * duoc xep hang cach nhau it nhat LOAD_GAP_TICKS (tick FLEXCAN0_TIMER_HZ,
+ * 0 = lien tuc, lap day moi mailbox truyen dang trong) */
+#define LOAD_GAP_TICKS  (0UL)
+static const uint32_t s_load_ids[] = { TX_MSG_ID, 0x100U, 0x3FFU, 0x7FFU };
+static const uint8_t s_load_lengths[] = { 8U, 8U, 4U, 1U, 0U, 8U };
+
+/* Bo dem truyen, xem bang debugger */
+flexcan_bus_stats_t g_load_stats;
+uint32_t g_load_queued = 0;
+
+static void LoadGenerator_Run(void)
+{
+    uint8_t payload[FLEXCAN0_PAYLOAD_SIZE] = {0};
+    uint32_t id_idx = 0;
+    uint32_t len_idx = 0;
+#if LOAD_GAP_TICKS != 0UL
+    uint32_t last_queued = FLEXCAN0_get_time();
+#endif
+
+    while(1)
+    {
+        FLEXCAN0_poll_bus_stats(&g_load_stats);
+
+#if LOAD_GAP_TICKS != 0UL
+        if ((FLEXCAN0_get_time() - last_queued) < LOAD_GAP_TICKS)
+        {
+            continue;
+        }
+#endif
+
+        /* Payload chua bo dem tang dan de cac khung tren bus khac nhau */
+        payload[0] = (uint8_t)g_load_queued;
+        payload[1] = (uint8_t)(g_load_queued >> 8);
+        if (FLEXCAN0_transmit_msg_id(s_load_ids[id_idx], payload, s_load_lengths[len_idx], NULL) == STATUS_SUCCESS)
+        {
+            g_load_queued++;
+#if LOAD_GAP_TICKS != 0UL
+            last_queued = FLEXCAN0_get_time();
+#endif
+            id_idx = (id_idx + 1U) % (sizeof(s_load_ids) / sizeof(s_load_ids[0]));
+            len_idx = (len_idx + 1U) % sizeof(s_load_lengths);
+        }
+    }
+}
+#endif
+
+#if BENCHMARK_PINGPONG
+static bool BenchSend(const uint8_t *data, uint8_t length, uint8_t *handle)
+{
+    return FLEXCAN0_transmit_msg(data, length, handle) == STATUS_SUCCESS;
+}
+
+static bool BenchTxTime(uint8_t handle, uint32_t *timestamp)
+{
+    return FLEXCAN0_get_tx_time(handle, timestamp) != 0U;
+}
+
+static const bench_port_t s_bench_port = {
+    BenchSend, FLEXCAN0_receive_msg, BenchTxTime, FLEXCAN0_get_time
+};
+
+/* Thong ke RTT (tick FLEXCAN0_TIMER_HZ), xem bang debugger hoac
+ * BENCH_RttAvg/BENCH_RttP99/BENCH_FramesPerSecond */
+bench_stats_t g_bench_stats;
+#endif
+
 
 int main(void)
 {
     /* Do the initializations required for this application */
     BoardInit();
+    TIMEBASE_Init();
     GPIOInit();
-    LPIT0_Init();
     FLEXCAN0_init();
 
+#if LOAD_GENERATOR
+    LoadGenerator_Run();
+#endif
 
+#if BENCHMARK_PINGPONG
+    BENCH_Init(&s_bench_port, &g_bench_stats);
     while(1)
     {
-    	if (g_send_flag && (g_millis > current_time + MULTI_PRESS_TIMEOUT_MS))
-    	{
-    	    uint8_t tx_buf[4] = {g_speed_value_to_send, 0, 0, 0};
-    	    FLEXCAN0_transmit_msg(tx_buf);
-    	    g_send_flag = false;
-    	    speed = 0;
-    	}
-
+        BENCH_Step();
     }
+#endif
+
+    SCHED_Init();
+    SCHED_Register(EVT_CAN_RX, CanTask_OnRx);
+    SCHED_Register(EVT_BUTTON, ButtonTask_OnSettled);
+    SCHED_Register(EVT_GESTURE, GestureTask_OnTimer);
+    GESTURE_Init(&s_gesture_port);
+    SCHED_Register(EVT_RETRY, SpeedTask_OnRetry);
+    SCHED_Register(EVT_STATS, StatsTask_OnTimer);
+    TIMEBASE_StartIn(TIMER_STATS, STATS_PERIOD_MS * 1000UL, StatsTimerExpired);
+    FLEXCAN0_enable_rx_irq(CanRxNotify);
+    SCHED_Run();
 
     for(;;) {
       if(exit_code != 0) {
@@ -0,0 +1,204 @@
+#include <stddef.h>
+#include "s32_core_cm4.h" // DISABLE_INTERRUPTS, ENABLE_INTERRUPTS, STANDBY
+#include "scheduler.h"
+
+/* Core debug registers, not described by the device header */
+#define DEMCR        (*(volatile uint32_t *)0xE000EDFCUL)
+#define DEMCR_TRCENA (1UL << 24)
+#define DWT_CTRL     (*(volatile uint32_t *)0xE0001000UL)
+#define DWT_CTRL_CYCCNTENA (1UL << 0)
+#define DWT_CYCCNT   (*(volatile uint32_t *)0xE0001004UL)
+
+/* Keep the compiler and the core from reordering queue data and index accesses */
+#define QUEUE_BARRIER() __asm volatile ("dmb" : : : "memory")
+
+typedef struct {
+    uint32_t event;
+    uint32_t arg;
+    uint32_t posted_at; // DWT_CYCCNT when posted
+} sched_event_t;
+
+typedef struct {
+    sched_event_t buf[SCHED_QUEUE_SIZE];
+    volatile uint32_t head;    // written only by the producer
+    volatile uint32_t tail;    // written only by the dispatcher
+    volatile uint32_t dropped; // written only by the producer
+} sched_queue_t;
+
+static sched_queue_t s_queues[SCHED_SOURCE_COUNT];
+static sched_handler_t s_handlers[SCHED_EVENT_COUNT];
+static sched_stats_t s_stats;
+static uint32_t s_last_cycles = 0; // DWT_CYCCNT at the last total_cycles update
+
+/*
+ * Fold the cycles elapsed since the last call into total_cycles. Called at
+ * least once per dispatch or wake-up, far more often than CYCCNT wraps
+ * (89 s at 48 MHz) as long as some interrupt is enabled.
+ */
+static uint32_t SCHED_UpdateTotal(void) {
+    uint32_t now = DWT_CYCCNT;
+
+    s_stats.total_cycles += (uint32_t)(now - s_last_cycles);
+    s_last_cycles = now;
+    return now;
+}
+
+/**
+ * Clear all queues and handlers and start the cycle counter.
+ */
+void SCHED_Init(void) {
+    uint32_t i;
+
+    for (i = 0; i < SCHED_SOURCE_COUNT; i++) {
+        s_queues[i].head = 0;
+        s_queues[i].tail = 0;
+        s_queues[i].dropped = 0;
+    }
+    for (i = 0; i < SCHED_EVENT_COUNT; i++) {
+        s_handlers[i] = NULL;
+    }
+
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+
+    s_stats.total_cycles = 0;
+    s_stats.idle_cycles = 0;
+    s_stats.dispatched = 0;
+    s_stats.dropped = 0;
+    s_stats.latency_max = 0;
+    s_stats.latency_last = 0;
+    s_last_cycles = DWT_CYCCNT;
+}
+
+/**
+ * Attach a handler to an event id. Events without a handler are discarded.
+ */
+void SCHED_Register(uint32_t event, sched_handler_t handler) {
+    if (event < SCHED_EVENT_COUNT) {
+        s_handlers[event] = handler;
+    }
+}
+
+/**
+ * Queue an event. Each source index must be used by a single context only
+ * (one interrupt handler, or main), which is what makes this lock-free.
+ *
+ * @param source Queue of the calling context, 0 = highest priority.
+ * @param event  Event id, selects the handler.
+ * @param arg    Passed to the handler.
+ * @return false if the queue was full and the event was dropped.
+ */
+bool SCHED_Post(uint32_t source, uint32_t event, uint32_t arg) {
+    sched_queue_t *q = &s_queues[source];
+    uint32_t head = q->head;
+    uint32_t next = (head + 1U) & (SCHED_QUEUE_SIZE - 1U);
+
+    if (next == q->tail) {
+        q->dropped++;
+        return false;
+    }
+    q->buf[head].event = event;
+    q->buf[head].arg = arg;
+    q->buf[head].posted_at = DWT_CYCCNT;
+    QUEUE_BARRIER();
+    q->head = next;
+    return true;
+}
+
+/**
+ * Dispatch the oldest event of the highest priority non-empty queue.
+ *
+ * @return true if an event was handled, false if all queues were empty.
+ */
+bool SCHED_RunOnce(void) {
+    uint32_t i;
+
+    for (i = 0; i < SCHED_SOURCE_COUNT; i++) {
+        sched_queue_t *q = &s_queues[i];
+        uint32_t tail = q->tail;
+
+        if (tail != q->head) {
+            sched_event_t e;
+            uint32_t latency;
+
+            QUEUE_BARRIER();
+            e = q->buf[tail];
+            QUEUE_BARRIER();
+            q->tail = (tail + 1U) & (SCHED_QUEUE_SIZE - 1U);
+
+            latency = SCHED_UpdateTotal() - e.posted_at;
+            s_stats.latency_last = latency;
+            if (latency > s_stats.latency_max) {
+                s_stats.latency_max = latency;
+            }
+            s_stats.dispatched++;
+
+            if ((e.event < SCHED_EVENT_COUNT) && (s_handlers[e.event] != NULL)) {
+                s_handlers[e.event](e.arg);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * True if any queue holds an event.
+ */
+static bool SCHED_Pending(void) {
+    uint32_t i;
+
+    for (i = 0; i < SCHED_SOURCE_COUNT; i++) {
+        if (s_queues[i].tail != s_queues[i].head) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Dispatch events forever, sleeping in WFI whenever nothing is pending.
+ */
+void SCHED_Run(void) {
+    while (1) {
+        if (SCHED_RunOnce()) {
+            continue;
+        }
+
+        /* Check with interrupts masked so a post between the test and WFI
+         * still wakes the core; the handler runs after ENABLE_INTERRUPTS,
+         * outside the idle measurement. */
+        DISABLE_INTERRUPTS();
+        if (!SCHED_Pending()) {
+            uint32_t start = SCHED_UpdateTotal();
+            STANDBY();
+            s_stats.idle_cycles += (uint32_t)(SCHED_UpdateTotal() - start);
+        }
+        ENABLE_INTERRUPTS();
+    }
+}
+
+/**
+ * Snapshot of the scheduler statistics, call from main() context.
+ */
+void SCHED_GetStats(sched_stats_t *stats) {
+    uint32_t i;
+
+    (void)SCHED_UpdateTotal();
+    *stats = s_stats;
+    stats->dropped = 0;
+    for (i = 0; i < SCHED_SOURCE_COUNT; i++) {
+        stats->dropped += s_queues[i].dropped;
+    }
+}
+
+/**
+ * @return Share of time spent in WFI, in percent.
+ */
+uint32_t SCHED_IdlePercent(const sched_stats_t *stats) {
+    if (stats->total_cycles == 0U) {
+        return 0U;
+    }
+    return (uint32_t)((stats->idle_cycles * 100U) / stats->total_cycles);
+}
@@ -0,0 +1,53 @@
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Cooperative run-to-completion scheduler.
+ *
+ * Interrupt handlers post events, main() dispatches them one at a time to
+ * the handler registered for the event and sleeps (WFI) when every queue is
+ * empty. Each event source owns one single-producer/single-consumer queue,
+ * so posting needs no lock: only that source writes the head and only the
+ * dispatcher writes the tail. Queues are served in index order, a lower
+ * source index has priority.
+ *
+ * Idle time and dispatch latency are measured with the DWT cycle counter
+ * (core clock cycles).
+ */
+
+#define SCHED_SOURCE_COUNT  (4U)   // Event queues, one per producer
+#define SCHED_QUEUE_SIZE    (8U)   // Events per queue, must be a power of 2
+#define SCHED_EVENT_COUNT   (8U)   // Distinct event ids
+
+#if (SCHED_QUEUE_SIZE & (SCHED_QUEUE_SIZE - 1U)) != 0U
+#error "SCHED_QUEUE_SIZE must be a power of 2"
+#endif
+
+/* Handler for one event, runs to completion in main() context */
+typedef void (*sched_handler_t)(uint32_t arg);
+
+/**
+ * Scheduler statistics, kept in RAM for the debugger.
+ */
+typedef struct {
+    uint64_t total_cycles;     /* Cycles since SCHED_Init */
+    uint64_t idle_cycles;      /* Cycles spent in WFI */
+    uint32_t dispatched;       /* Events handled */
+    uint32_t dropped;          /* Events lost because a queue was full */
+    uint32_t latency_max;      /* Worst post-to-dispatch delay in cycles */
+    uint32_t latency_last;     /* Post-to-dispatch delay of the last event */
+} sched_stats_t;
+
+void SCHED_Init(void);
+void SCHED_Register(uint32_t event, sched_handler_t handler);
+bool SCHED_Post(uint32_t source, uint32_t event, uint32_t arg);
+bool SCHED_RunOnce(void);
+void SCHED_Run(void);
+
+void SCHED_GetStats(sched_stats_t *stats);
+uint32_t SCHED_IdlePercent(const sched_stats_t *stats);
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,181 @@
+#include <stddef.h>
+#include "S32K144.h"
+#include <interrupt_manager.h>
+#include "s32_core_cm4.h" // DISABLE_INTERRUPTS
+#include "timebase.h"
+
+#define TIMEBASE_TICKS_PER_US  (TIMEBASE_CLK_HZ / 1000000UL)
+
+#define CH_PRESCALE  (0U) // Clock to 1 MHz
+#define CH_LOW       (1U) // Microseconds, low word (chained to CH0)
+#define CH_HIGH      (2U) // Microseconds, high word (chained to CH1)
+#define CH_DEADLINE  (3U) // One-shot deadline
+
+typedef struct {
+    uint64_t deadline;             // Absolute time in microseconds
+    timebase_callback_t callback;  // NULL when the timer is stopped
+} timebase_timer_t;
+
+static timebase_timer_t s_timers[TIMEBASE_TIMER_COUNT];
+
+/*
+ * The chained channels count down from 0xFFFFFFFF, so elapsed time is the
+ * complement. The high word is read before and after the low word; if it
+ * moved, the low word wrapped in between and is read again.
+ */
+uint64_t TIMEBASE_NowUs(void) {
+    uint32_t hi = ~LPIT0->TMR[CH_HIGH].CVAL;
+    uint32_t lo = ~LPIT0->TMR[CH_LOW].CVAL;
+    uint32_t hi2 = ~LPIT0->TMR[CH_HIGH].CVAL;
+
+    if (hi2 != hi) {
+        lo = ~LPIT0->TMR[CH_LOW].CVAL;
+    }
+    return ((uint64_t)hi2 << 32) | lo;
+}
+
+/**
+ * @return Milliseconds since TIMEBASE_Init, wraps after 49 days.
+ */
+uint32_t TIMEBASE_NowMs(void) {
+    return (uint32_t)(TIMEBASE_NowUs() / 1000U);
+}
+
+/*
+ * Critical section around the timer table. Start/Stop are called from
+ * main and from other interrupts (button, capture), so the caller's PRIMASK
+ * is saved and restored instead of toggling the LPIT IRQ: a nested call
+ * must not re-enable anything inside the outer section.
+ */
+static inline uint32_t TIMEBASE_Lock(void) {
+    uint32_t primask;
+
+    __asm volatile ("mrs %0, primask" : "=r" (primask));
+    DISABLE_INTERRUPTS();
+    return primask;
+}
+
+static inline void TIMEBASE_Unlock(uint32_t primask) {
+    __asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+/*
+ * Arm CH3 for the earliest running timer, or leave it stopped if none is.
+ * Deadlines beyond the 32-bit channel range fire early and re-arm.
+ */
+static void TIMEBASE_Rearm(void) {
+    uint64_t earliest = UINT64_MAX;
+    uint64_t now;
+    uint64_t ticks;
+    uint32_t i;
+
+    LPIT0->CLRTEN = LPIT_CLRTEN_CLR_T_EN_3_MASK;
+    LPIT0->MSR = LPIT_MSR_TIF3_MASK;
+
+    for (i = 0; i < TIMEBASE_TIMER_COUNT; i++) {
+        if ((s_timers[i].callback != NULL) && (s_timers[i].deadline < earliest)) {
+            earliest = s_timers[i].deadline;
+        }
+    }
+    if (earliest == UINT64_MAX) {
+        return;
+    }
+
+    now = TIMEBASE_NowUs();
+    ticks = (earliest > now) ? ((earliest - now) * TIMEBASE_TICKS_PER_US) : 2U;
+    if (ticks > 0xFFFFFFFFUL) {
+        ticks = 0xFFFFFFFFUL;
+    }
+    LPIT0->TMR[CH_DEADLINE].TVAL = (uint32_t)ticks - 1U;
+    LPIT0->SETTEN = LPIT_SETTEN_SET_T_EN_3_MASK;
+}
+
+/**
+ * Start the free-running counter. CH3 stays idle until a timer is started.
+ */
+void TIMEBASE_Init(void) {
+    uint32_t i;
+
+    for (i = 0; i < TIMEBASE_TIMER_COUNT; i++) {
+        s_timers[i].callback = NULL;
+    }
+
+    PCC->PCCn[PCC_LPIT_INDEX] |= PCC_PCCn_CGC_MASK;
+    LPIT0->MCR = LPIT_MCR_M_CEN_MASK | LPIT_MCR_DBG_EN_MASK; // Run in debug mode too
+
+    LPIT0->TMR[CH_PRESCALE].TVAL = TIMEBASE_TICKS_PER_US - 1U;
+    LPIT0->TMR[CH_PRESCALE].TCTRL = 0;
+    LPIT0->TMR[CH_LOW].TVAL = 0xFFFFFFFFUL;
+    LPIT0->TMR[CH_LOW].TCTRL = LPIT_TMR_TCTRL_CHAIN_MASK;
+    LPIT0->TMR[CH_HIGH].TVAL = 0xFFFFFFFFUL;
+    LPIT0->TMR[CH_HIGH].TCTRL = LPIT_TMR_TCTRL_CHAIN_MASK;
+    // One-shot: stop after the timeout until re-enabled
+    LPIT0->TMR[CH_DEADLINE].TCTRL = LPIT_TMR_TCTRL_TSOI_MASK;
+
+    // Start the chain together so CH1/CH2 begin at a whole microsecond
+    LPIT0->SETTEN = LPIT_SETTEN_SET_T_EN_0_MASK | LPIT_SETTEN_SET_T_EN_1_MASK | LPIT_SETTEN_SET_T_EN_2_MASK;
+
+    LPIT0->MIER = LPIT_MIER_TIE3_MASK;
+    INT_SYS_EnableIRQ(LPIT0_Ch3_IRQn);
+}
+
+/**
+ * Start (or restart) a software timer.
+ *
+ * @param timer       0..TIMEBASE_TIMER_COUNT-1
+ * @param deadline_us Absolute time (TIMEBASE_NowUs) to fire at, a past time fires at once.
+ * @param callback    Runs in interrupt context, once.
+ */
+void TIMEBASE_Start(uint32_t timer, uint64_t deadline_us, timebase_callback_t callback) {
+    uint32_t primask;
+
+    if (timer >= TIMEBASE_TIMER_COUNT) {
+        return;
+    }
+    primask = TIMEBASE_Lock();
+    s_timers[timer].deadline = deadline_us;
+    s_timers[timer].callback = callback;
+    TIMEBASE_Rearm();
+    TIMEBASE_Unlock(primask);
+}
+
+/**
+ * Start a software timer delay_us from now, see TIMEBASE_Start().
+ */
+void TIMEBASE_StartIn(uint32_t timer, uint32_t delay_us, timebase_callback_t callback) {
+    TIMEBASE_Start(timer, TIMEBASE_NowUs() + delay_us, callback);
+}
+
+/**
+ * Stop a software timer; CH3 is disabled when no timer is left.
+ */
+void TIMEBASE_Stop(uint32_t timer) {
+    uint32_t primask;
+
+    if (timer >= TIMEBASE_TIMER_COUNT) {
+        return;
+    }
+    primask = TIMEBASE_Lock();
+    s_timers[timer].callback = NULL;
+    TIMEBASE_Rearm();
+    TIMEBASE_Unlock(primask);
+}
+
+/*
+ * Deadline interrupt: run every expired timer, then arm for the next one.
+ */
+void LPIT0_Ch3_IRQHandler(void) {
+    uint64_t now = TIMEBASE_NowUs();
+    uint32_t i;
+
+    LPIT0->MSR = LPIT_MSR_TIF3_MASK;
+    for (i = 0; i < TIMEBASE_TIMER_COUNT; i++) {
+        timebase_callback_t callback = s_timers[i].callback;
+
+        if ((callback != NULL) && (s_timers[i].deadline <= now)) {
+            s_timers[i].callback = NULL;
+            callback();
+        }
+    }
+    TIMEBASE_Rearm();
+}
@@ -0,0 +1,38 @@
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Tickless 64-bit microsecond timebase on LPIT0.
+ *
+ * CH0 divides the LPIT functional clock down to 1 MHz, CH1 and CH2 are
+ * chained behind it and count microseconds as the low and high word of a
+ * 64-bit down-counter. Nothing interrupts while time just passes; reads
+ * take the hi/lo/hi registers directly.
+ *
+ * CH3 is a one-shot used for deadlines: it is armed for the earliest
+ * pending software timer only, and its interrupt runs the expired timer
+ * callbacks.
+ */
+
+#define TIMEBASE_CLK_HZ      (8000000UL) // LPIT0 functional clock (SIRC_DIV2)
+#define TIMEBASE_TIMER_COUNT (4U)        // Software timers sharing CH3
+
+#if (TIMEBASE_CLK_HZ % 1000000UL) != 0UL
+#error "TIMEBASE_CLK_HZ must be a whole number of MHz"
+#endif
+
+/* Called from the LPIT0 CH3 interrupt when a timer expires */
+typedef void (*timebase_callback_t)(void);
+
+void TIMEBASE_Init(void);
+uint64_t TIMEBASE_NowUs(void);
+uint32_t TIMEBASE_NowMs(void);
+
+void TIMEBASE_Start(uint32_t timer, uint64_t deadline_us, timebase_callback_t callback);
+void TIMEBASE_StartIn(uint32_t timer, uint32_t delay_us, timebase_callback_t callback);
+void TIMEBASE_Stop(uint32_t timer);
+
+#endif /* TIMEBASE_H_ */
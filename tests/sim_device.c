@@ -0,0 +1,33 @@
+#include <stddef.h>
+#include "s32_core_cm4.h"
+#include "interrupt_manager.h"
+
+CAN_Type g_sim_can0;
+PCC_Type g_sim_pcc;
+volatile uint32_t g_sim_primask = 0U;
+
+static isr_t s_handlers[NUMBER_OF_INT_VECTORS];
+static bool s_enabled[NUMBER_OF_INT_VECTORS];
+
+void INT_SYS_InstallHandler(IRQn_Type irqNumber, const isr_t newHandler, isr_t* const oldHandler) {
+    if (oldHandler != NULL) {
+        *oldHandler = s_handlers[irqNumber];
+    }
+    s_handlers[irqNumber] = newHandler;
+}
+
+void INT_SYS_EnableIRQ(IRQn_Type irqNumber) {
+    s_enabled[irqNumber] = true;
+}
+
+void INT_SYS_DisableIRQ(IRQn_Type irqNumber) {
+    s_enabled[irqNumber] = false;
+}
+
+bool SIM_Irq(IRQn_Type irq) {
+    if (!s_enabled[irq] || (g_sim_primask != 0U) || (s_handlers[irq] == NULL)) {
+        return false;
+    }
+    s_handlers[irq]();
+    return true;
+}
@@ -0,0 +1,2 @@
+/* The applications include <FlexCan.h>, the file is FlexCAN.h */
+#include "FlexCAN.h"
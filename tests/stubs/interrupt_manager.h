@@ -0,0 +1,17 @@
+#ifndef INTERRUPT_MANAGER_H
+#define INTERRUPT_MANAGER_H
+
+/*
+ * Host stand-in for the SDK interrupt manager. Handlers and enables are
+ * recorded by sim_device.c; the test calls SIM_Irq() to take an interrupt.
+ */
+
+#include "sim_device.h"
+
+typedef void (* isr_t)(void);
+
+void INT_SYS_InstallHandler(IRQn_Type irqNumber, const isr_t newHandler, isr_t* const oldHandler);
+void INT_SYS_EnableIRQ(IRQn_Type irqNumber);
+void INT_SYS_DisableIRQ(IRQn_Type irqNumber);
+
+#endif /* INTERRUPT_MANAGER_H */
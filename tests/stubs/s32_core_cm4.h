@@ -0,0 +1,24 @@
+#ifndef CORE_CM4_H
+#define CORE_CM4_H
+
+/*
+ * Host stand-in for the SDK s32_core_cm4.h: same macros, no Cortex-M4
+ * instructions. Interrupt masking only tracks PRIMASK in g_sim_primask.
+ */
+
+#include <stdint.h>
+
+extern volatile uint32_t g_sim_primask;
+
+#define ENABLE_INTERRUPTS()  (g_sim_primask = 0U)
+#define DISABLE_INTERRUPTS() (g_sim_primask = 1U)
+#define STANDBY()            ((void)0)
+#define NOP()                ((void)0)
+
+#define REV_BYTES_32(a, b)   ((b) = __builtin_bswap32(a))
+#define REV_BYTES_16(a, b)   ((b) = (((a) & 0xFF00FF00U) >> 8U) | (((a) & 0x00FF00FFU) << 8U))
+
+/* Little endian, as the Cortex-M4 */
+#define CORE_LITTLE_ENDIAN
+
+#endif /* CORE_CM4_H */
@@ -0,0 +1,27 @@
+#ifndef SIM_DEVICE_H_
+#define SIM_DEVICE_H_
+
+/*
+ * Simulated S32K144 peripherals for the host tests.
+ *
+ * The register layouts come from the real device header; only the base
+ * address macros are pointed at plain structures, so application code runs
+ * unchanged against memory the test drives. Write-1-to-clear and other side
+ * effects are not modelled, each test emulates what it relies on.
+ */
+
+#include <stdbool.h>
+#include "S32K144.h"
+
+extern CAN_Type g_sim_can0;
+extern PCC_Type g_sim_pcc;
+
+#undef CAN0
+#define CAN0 (&g_sim_can0)
+#undef PCC
+#define PCC (&g_sim_pcc)
+
+/* Run the installed handler of irq; returns false if it is not enabled */
+bool SIM_Irq(IRQn_Type irq);
+
+#endif /* SIM_DEVICE_H_ */
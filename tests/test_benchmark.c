@@ -0,0 +1,157 @@
+/*
+ * Can_Transmit ping-pong benchmark (benchmark.c) on a simulated bus.
+ *
+ * bench_port_t is implemented by a two-node 500 kbit/s bus model: the
+ * ping goes out when the bus is idle, the echo node answers after a
+ * pseudo-random turnaround and every frame takes its full length in bit
+ * times. Timer ticks are bit times, as with FLEXCAN0_TIMER_HZ on the EVB.
+ * The echo node drops every ECHO_DROP_EVERY-th ping to exercise the
+ * timeout path. Checked: every round trip is matched or counted lost,
+ * and min/max/avg RTT agree with the model.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "benchmark.c"
+
+#define BITRATE          (500000UL)
+#define PING_COUNT       (20000UL)
+#define ECHO_MIN_TICKS   (10UL)    // Echo node turnaround, 20 us ..
+#define ECHO_SPAN_TICKS  (40UL)    // .. 100 us
+#define ECHO_DROP_EVERY  (1000UL)
+#define STEP_TICKS       (1UL)     // Main loop period of the transmitter
+
+static uint32_t s_now = 0;
+static uint32_t s_failures = 0;
+static uint32_t s_rng = 1;
+
+/* Transmitter side */
+static bool s_tx_busy = false;
+static uint32_t s_tx_end = 0;          // Ping leaves the bus
+/* Echo side */
+static bool s_echo_pending = false;
+static uint32_t s_echo_end = 0;        // Echo received by the transmitter
+static uint8_t s_echo_data[BENCH_FRAME_LEN];
+static uint32_t s_echo_len = 0;
+/* Model results */
+static uint32_t s_pings = 0;
+static uint32_t s_dropped = 0;
+static uint32_t s_rtt_min = 0xFFFFFFFFUL;
+static uint32_t s_rtt_max = 0;
+static uint64_t s_rtt_sum = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)) { s_failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+                              printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+/* Standard data frame with len bytes, no stuff bits, plus 3 bits interframe space */
+static uint32_t FrameBits(uint32_t len) {
+    return 47UL + (8UL * len);
+}
+
+static uint32_t Random(void) {
+    s_rng = (s_rng * 1103515245UL) + 12345UL;
+    return s_rng >> 16;
+}
+
+static bool SimSend(const uint8_t *data, uint8_t length, uint8_t *handle) {
+    uint32_t turnaround;
+
+    if (s_tx_busy) {
+        return false;
+    }
+    s_tx_busy = true;
+    s_tx_end = s_now + FrameBits(length);
+    *handle = 0;
+
+    s_pings++;
+    if ((s_pings % ECHO_DROP_EVERY) == 0UL) {
+        s_dropped++;
+        return true;
+    }
+    turnaround = ECHO_MIN_TICKS + (Random() % (ECHO_SPAN_TICKS + 1UL));
+    memcpy(s_echo_data, data, length);
+    s_echo_len = length;
+    s_echo_end = s_tx_end + turnaround + FrameBits(length);
+    s_echo_pending = true;
+
+    /* RTT seen by the benchmark: TX timestamp to RX timestamp */
+    if ((turnaround + FrameBits(length)) < s_rtt_min) {
+        s_rtt_min = turnaround + FrameBits(length);
+    }
+    if ((turnaround + FrameBits(length)) > s_rtt_max) {
+        s_rtt_max = turnaround + FrameBits(length);
+    }
+    s_rtt_sum += turnaround + FrameBits(length);
+    return true;
+}
+
+static uint32_t SimReceive(uint8_t *data, uint32_t *timestamp) {
+    if (!s_echo_pending || ((int32_t)(s_now - s_echo_end) < 0)) {
+        return 0U;
+    }
+    s_echo_pending = false;
+    memcpy(data, s_echo_data, s_echo_len);
+    *timestamp = s_echo_end;
+    return s_echo_len;
+}
+
+static bool SimTxTime(uint8_t handle, uint32_t *timestamp) {
+    (void)handle;
+    if ((int32_t)(s_now - s_tx_end) < 0) {
+        return false;
+    }
+    *timestamp = s_tx_end;
+    return true;
+}
+
+static uint32_t SimNow(void) {
+    return s_now;
+}
+
+static const bench_port_t s_sim_port = {
+    SimSend, SimReceive, SimTxTime, SimNow
+};
+
+int main(void) {
+    bench_stats_t stats;
+    uint32_t resolved;
+
+    BENCH_Init(&s_sim_port, &stats);
+    while (stats.sent < PING_COUNT) {
+        BENCH_Step();
+        s_now += STEP_TICKS;
+        if (s_tx_busy && ((int32_t)(s_now - s_tx_end) >= 0)) {
+            s_tx_busy = false;
+        }
+    }
+    /* Let the last ping finish */
+    resolved = stats.matched + stats.lost;
+    while ((stats.matched + stats.lost) == resolved) {
+        BENCH_Step();
+        s_now += STEP_TICKS;
+    }
+
+    CHECK(stats.sent == s_pings, "sent %lu, bus saw %lu", (unsigned long)stats.sent, (unsigned long)s_pings);
+    CHECK(stats.matched + stats.lost == stats.sent, "%lu matched + %lu lost of %lu sent",
+          (unsigned long)stats.matched, (unsigned long)stats.lost, (unsigned long)stats.sent);
+    CHECK(stats.lost == s_dropped, "lost %lu, dropped %lu", (unsigned long)stats.lost, (unsigned long)s_dropped);
+    CHECK(stats.unexpected == 0U, "unexpected %lu", (unsigned long)stats.unexpected);
+    CHECK(stats.rtt_min == s_rtt_min, "rtt_min %lu, model %lu", (unsigned long)stats.rtt_min, (unsigned long)s_rtt_min);
+    CHECK(stats.rtt_max == s_rtt_max, "rtt_max %lu, model %lu", (unsigned long)stats.rtt_max, (unsigned long)s_rtt_max);
+    CHECK(stats.rtt_sum == s_rtt_sum, "rtt_sum %llu, model %llu",
+          (unsigned long long)stats.rtt_sum, (unsigned long long)s_rtt_sum);
+    CHECK((BENCH_RttP99(&stats) >= BENCH_RttAvg(&stats)) && (BENCH_RttP99(&stats) <= stats.rtt_max),
+          "p99 %lu ticks", (unsigned long)BENCH_RttP99(&stats));
+
+    printf("%lu pings at %lu bit/s: %lu matched, %lu lost, %lu unexpected\n",
+           (unsigned long)stats.sent, (unsigned long)BITRATE, (unsigned long)stats.matched,
+           (unsigned long)stats.lost, (unsigned long)stats.unexpected);
+    printf("RTT us: min %lu, avg %lu, p99 %lu, max %lu; %lu round trips/s\n",
+           (unsigned long)((stats.rtt_min * 1000000ULL) / BITRATE),
+           (unsigned long)((BENCH_RttAvg(&stats) * 1000000ULL) / BITRATE),
+           (unsigned long)((BENCH_RttP99(&stats) * 1000000ULL) / BITRATE),
+           (unsigned long)((stats.rtt_max * 1000000ULL) / BITRATE),
+           (unsigned long)BENCH_FramesPerSecond(&stats, BITRATE));
+
+    printf("%s\n", (s_failures == 0U) ? "PASS" : "FAILED");
+    return (s_failures == 0U) ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+/*
+ * Bit timing solver (can_timing.h) over clock/bitrate/sample point pairs.
+ *
+ * The solver macros are plain integer expressions, so they are checked
+ * both at build time (CAN_TIMING_CHECK on the configurations in use) and
+ * at run time over a grid of clocks, bitrates and sample points against a
+ * reference search over the same candidate quanta counts:
+ *   - when the solver finds a timing it is exact, every field is in range,
+ *     the segments add up and the sample point is within 5 %;
+ *   - the solver gives up only if no candidate quanta count works,
+ *     including the 5 % sample point tolerance.
+ */
+#include <stdio.h>
+#include "S32K144.h"
+#include "can_timing.h"
+
+/* The configurations the applications build with, plus common ones */
+CAN_TIMING_CHECK(8000000UL, 500000UL, 75UL, 1000UL);
+CAN_TIMING_CHECK(8000000UL, 250000UL, 87UL, 1000UL);
+CAN_TIMING_CHECK(40000000UL, 1000000UL, 80UL, 1000UL);
+CAN_TIMING_CHECK(80000000UL, 500000UL, 75UL, 1000UL);
+CAN_TIMING_CHECK(37500000UL, 500000UL, 75UL, 1000UL);
+CAN_TIMING_FD_CHECK(8000000UL, 1000000UL, 75UL);
+CAN_TIMING_FD_CHECK(80000000UL, 2000000UL, 80UL);
+
+_Static_assert(CAN_TIMING_CTRL1(0UL, 8000000UL, 500000UL, 75UL) == 0x00DB0006UL,
+               "8 MHz / 500 kbit/s must keep the original CTRL1 value");
+
+/* Candidate order of CAN_TIMING_TQ() */
+static const unsigned long s_candidates[] = {16, 20, 10, 8, 25, 24, 12, 18, 14, 15, 22, 9};
+
+static const unsigned long s_clocks[] = {
+    4000000UL, 8000000UL, 12000000UL, 12500000UL, 16000000UL, 20000000UL, 24000000UL,
+    37500000UL, 40000000UL, 48000000UL, 60000000UL, 64000000UL, 80000000UL, 112000000UL
+};
+static const unsigned long s_bitrates[] = {
+    33333UL, 50000UL, 83333UL, 100000UL, 125000UL, 250000UL, 500000UL, 800000UL, 1000000UL
+};
+static const unsigned long s_sample_points[] = {70UL, 75UL, 80UL, 87UL};
+
+static unsigned long s_failures = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)) { s_failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+                              printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+/* Reference: the segment rules of can_timing.h for one quanta count */
+static int ReferenceFits(unsigned long clk, unsigned long br, unsigned long sp, unsigned long tq) {
+    unsigned long pseg2 = ((tq * (100UL - sp)) + 50UL) / 100UL;
+    unsigned long tseg1;
+    unsigned long pseg1;
+    unsigned long propseg;
+
+    if (((clk % (br * tq)) != 0UL) || ((clk / (br * tq)) < 1UL) || ((clk / (br * tq)) > 256UL)) {
+        return 0;
+    }
+    pseg2 = (pseg2 < 2UL) ? 2UL : ((pseg2 > 8UL) ? 8UL : pseg2);
+    if ((tq - 1UL) < pseg2) {
+        return 0;
+    }
+    tseg1 = tq - 1UL - pseg2;
+    pseg1 = (tseg1 > (8UL + pseg2)) ? (tseg1 - 8UL) : pseg2;
+    propseg = tseg1 - pseg1;
+    return (tseg1 > pseg1) && (propseg >= 1UL) && (propseg <= 8UL) && (pseg1 <= 8UL) &&
+           CAN_TIMING_SP_OK(((1UL + tseg1) * 100UL) / tq, sp);
+}
+
+static void CheckPair(unsigned long clk, unsigned long br, unsigned long sp, unsigned long *solved) {
+    unsigned long tq = CAN_TIMING_TQ(clk, br, sp);
+    unsigned long i;
+
+    if (tq == 0UL) {
+        for (i = 0; i < (sizeof(s_candidates) / sizeof(s_candidates[0])); i++) {
+            CHECK(!ReferenceFits(clk, br, sp, s_candidates[i]),
+                  "%lu Hz / %lu bit/s / %lu %%: no timing, but %lu Tq fits", clk, br, sp, s_candidates[i]);
+        }
+        return;
+    }
+    (*solved)++;
+
+    unsigned long presc = CAN_TIMING_PRESC(clk, br, sp);
+    unsigned long propseg = CAN_TIMING_PROPSEG(clk, br, sp);
+    unsigned long pseg1 = CAN_TIMING_PSEG1(clk, br, sp);
+    unsigned long pseg2 = CAN_TIMING_PSEG2(clk, br, sp);
+    unsigned long rjw = CAN_TIMING_RJW(clk, br, sp);
+    unsigned long ctrl1 = CAN_TIMING_CTRL1(0UL, clk, br, sp);
+
+    CHECK(presc * tq * br == clk, "%lu Hz / %lu bit/s: %lu x %lu Tq is not exact", clk, br, presc, tq);
+    CHECK((presc >= 1UL) && (presc <= 256UL), "%lu Hz / %lu bit/s: prescaler %lu", clk, br, presc);
+    CHECK(1UL + propseg + pseg1 + pseg2 == tq, "%lu Hz / %lu bit/s: segments do not add up to %lu Tq",
+          clk, br, tq);
+    CHECK((propseg >= 1UL) && (propseg <= 8UL), "%lu Hz / %lu bit/s / %lu %%: PROPSEG %lu", clk, br, sp, propseg);
+    CHECK((pseg1 >= 1UL) && (pseg1 <= 8UL), "%lu Hz / %lu bit/s / %lu %%: PSEG1 %lu", clk, br, sp, pseg1);
+    CHECK((pseg2 >= 2UL) && (pseg2 <= 8UL), "%lu Hz / %lu bit/s / %lu %%: PSEG2 %lu", clk, br, sp, pseg2);
+    CHECK((rjw >= 1UL) && (rjw <= 4UL) && (rjw <= pseg1) && (rjw <= pseg2),
+          "%lu Hz / %lu bit/s / %lu %%: RJW %lu", clk, br, sp, rjw);
+    CHECK(CAN_TIMING_SP_OK(CAN_TIMING_SP_ACTUAL(clk, br, sp), sp),
+          "%lu Hz / %lu bit/s / %lu %%: sample point %lu %%", clk, br, sp, CAN_TIMING_SP_ACTUAL(clk, br, sp));
+
+    /* The register fields hold the values minus one */
+    CHECK(((ctrl1 & CAN_CTRL1_PRESDIV_MASK) >> CAN_CTRL1_PRESDIV_SHIFT) == presc - 1UL, "CTRL1 PRESDIV");
+    CHECK(((ctrl1 & CAN_CTRL1_PROPSEG_MASK) >> CAN_CTRL1_PROPSEG_SHIFT) == propseg - 1UL, "CTRL1 PROPSEG");
+    CHECK(((ctrl1 & CAN_CTRL1_PSEG1_MASK) >> CAN_CTRL1_PSEG1_SHIFT) == pseg1 - 1UL, "CTRL1 PSEG1");
+    CHECK(((ctrl1 & CAN_CTRL1_PSEG2_MASK) >> CAN_CTRL1_PSEG2_SHIFT) == pseg2 - 1UL, "CTRL1 PSEG2");
+    CHECK(((ctrl1 & CAN_CTRL1_RJW_MASK) >> CAN_CTRL1_RJW_SHIFT) == rjw - 1UL, "CTRL1 RJW");
+}
+
+int main(void) {
+    unsigned long pairs = 0;
+    unsigned long solved = 0;
+    unsigned long c;
+    unsigned long b;
+    unsigned long s;
+
+    for (c = 0; c < (sizeof(s_clocks) / sizeof(s_clocks[0])); c++) {
+        for (b = 0; b < (sizeof(s_bitrates) / sizeof(s_bitrates[0])); b++) {
+            for (s = 0; s < (sizeof(s_sample_points) / sizeof(s_sample_points[0])); s++) {
+                CheckPair(s_clocks[c], s_bitrates[b], s_sample_points[s], &solved);
+                pairs++;
+            }
+        }
+    }
+
+    /* 25 Tq only fits the clock here, and its PSEG1 (10) does not fit the field */
+    CHECK(CAN_TIMING_TQ(12500000UL, 500000UL, 75UL) == 0UL, "12.5 MHz / 500 kbit/s must be rejected");
+    /* 25 Tq comes before 15 Tq in the candidate list but does not fit */
+    CHECK(CAN_TIMING_TQ(37500000UL, 500000UL, 75UL) == 15UL, "37.5 MHz / 500 kbit/s must use 15 Tq");
+
+    printf("%lu clock/bitrate/sample point combinations, %lu solved\n", pairs, solved);
+    printf("%s\n", (s_failures == 0UL) ? "PASS" : "FAILED");
+    return (s_failures == 0UL) ? 0 : 1;
+}
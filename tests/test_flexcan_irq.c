@@ -0,0 +1,875 @@
+/*
+ * SDK FlexCAN interrupt dispatcher (FLEXCAN_IRQHandler) against a simulated
+ * CAN0, compared with the dispatcher it replaced.
+ *
+ * N mailboxes are made ready at once, half of them completed transmissions
+ * and half received frames, spread over the top of the 32 mailboxes where
+ * the old search is slowest. The interrupt is taken until no enabled flag is
+ * left. For each dispatcher the harness reports the interrupt entries, the
+ * IFLAG/IMASK register accesses (each one a peripheral bus access on the
+ * target) and the host time per batch. Checked for both dispatchers:
+ *   - every mailbox gets exactly one callback, lowest mailbox first;
+ *   - received frames are copied intact;
+ *   - no flag is left set and every mailbox ends idle with its interrupt off.
+ * Host times only compare the two dispatchers with each other.
+ *
+ * The Rx FIFO ring channel configuration (FLEXCAN_ConfigRxFifoRingDMA) is
+ * replayed over three laps for ring sizes 2-64: every write must land in the
+ * first 16 bytes of its entry and each lap must end at the ring start.
+ *
+ * The ring reader (FLEXCAN_DRV_ReadRxFifoRing) runs against a simulated
+ * channel: a partial read, a read across the wrap, a read after the writer
+ * lapped it and a read the writer overtakes while it copies. The frames
+ * returned and ring->overruns are checked in each case.
+ *
+ * The transmit queue (FLEXCAN_DRV_SendQueued) feeds four mailboxes from more
+ * frames than they hold: bursts of one ID mixed with standard and extended
+ * IDs, and a backlog waiting behind busy mailboxes. The simulated controller
+ * sends the lowest ID first, then the lowest mailbox. The bus order, the
+ * sent/rejected counters and a full queue and mailboxes the controller
+ * refuses are checked.
+ *
+ * A continuous-receive mailbox (FLEXCAN_DRV_ReceiveContinuous) gets more
+ * frames than its queue holds: the extra ones are dropped with the flag
+ * cleared and the mailbox still armed. The queue is streamed past the 16-bit
+ * head/tail wrap and read after FLEXCAN_DRV_AbortTransfer. The frames read
+ * and the received/overflows counters are checked.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sim_device.h"
+#include "s32_core_cm4.h"
+
+/* Flag register accessors with write-1-to-clear and an access count */
+#define FLEXCAN_GetMsgBuffIntStatusFlag   FLEXCAN_GetMsgBuffIntStatusFlag_hw
+#define FLEXCAN_GetMsgBuffIntStatusWord   FLEXCAN_GetMsgBuffIntStatusWord_hw
+#define FLEXCAN_ClearMsgBuffIntStatusFlag FLEXCAN_ClearMsgBuffIntStatusFlag_hw
+#define FLEXCAN_ClearMsgBuffIntStatusWord FLEXCAN_ClearMsgBuffIntStatusWord_hw
+#include "flexcan_hw_access.h"
+#undef FLEXCAN_GetMsgBuffIntStatusFlag
+#undef FLEXCAN_GetMsgBuffIntStatusWord
+#undef FLEXCAN_ClearMsgBuffIntStatusFlag
+#undef FLEXCAN_ClearMsgBuffIntStatusWord
+
+static uint32_t s_flag_accesses = 0;
+
+static inline uint8_t FLEXCAN_GetMsgBuffIntStatusFlag(const CAN_Type * base, uint32_t msgBuffIdx)
+{
+    s_flag_accesses += 2U;  // IMASK1, IFLAG1
+    return FLEXCAN_GetMsgBuffIntStatusFlag_hw(base, msgBuffIdx);
+}
+
+static inline uint32_t FLEXCAN_GetMsgBuffIntStatusWord(const CAN_Type * base, uint32_t word)
+{
+    s_flag_accesses += 2U;
+    return FLEXCAN_GetMsgBuffIntStatusWord_hw(base, word);
+}
+
+static inline void FLEXCAN_ClearMsgBuffIntStatusFlag(CAN_Type * base, uint32_t msgBuffIdx)
+{
+    s_flag_accesses++;
+    base->IFLAG1 &= ~((uint32_t)1U << msgBuffIdx);
+}
+
+static inline void FLEXCAN_ClearMsgBuffIntStatusWord(CAN_Type * base, uint32_t word, uint32_t mask)
+{
+    (void)word;
+    s_flag_accesses++;
+    base->IFLAG1 &= ~mask;
+}
+
+#define FLEXCAN_QUEUE_BARRIER() __sync_synchronize()
+#include "flexcan_hw_access.c"
+#include "flexcan_driver.c"
+
+#define ROUNDS     (20000UL)
+#define RX_ID      (0x123UL)
+
+static flexcan_state_t s_state;
+static flexcan_msgbuff_t s_rx_frames[FEATURE_CAN_MAX_MB_NUM];
+static uint32_t s_events[FEATURE_CAN_MAX_MB_NUM];
+static uint32_t s_order[FEATURE_CAN_MAX_MB_NUM];
+static uint32_t s_event_count = 0;
+static uint32_t s_failures = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)) { s_failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+                              printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+/* Host stand-ins for the SDK services the driver links against */
+status_t OSIF_SemaPost(semaphore_t * const pSem) { (void)pSem; return STATUS_SUCCESS; }
+status_t OSIF_SemaWait(semaphore_t * const pSem, const uint32_t timeout) { (void)pSem; (void)timeout; return STATUS_SUCCESS; }
+status_t OSIF_SemaCreate(semaphore_t * const pSem, const uint8_t initValue) { (void)pSem; (void)initValue; return STATUS_SUCCESS; }
+status_t OSIF_SemaDestroy(const semaphore_t * const pSem) { (void)pSem; return STATUS_SUCCESS; }
+status_t CLOCK_SYS_GetFreq(clock_names_t clockName, uint32_t *frequency) { (void)clockName; *frequency = 8000000U; return STATUS_SUCCESS; }
+/* eDMA: the loop transfer of the Rx FIFO ring is recorded, nothing else is run here */
+static edma_transfer_config_t s_dma_config;
+static edma_loop_transfer_config_t s_dma_loop;
+status_t EDMA_DRV_InstallCallback(uint8_t virtualChannel, edma_callback_t callback, void *parameter)
+{ (void)virtualChannel; (void)callback; (void)parameter; return STATUS_SUCCESS; }
+status_t EDMA_DRV_ConfigSingleBlockTransfer(uint8_t virtualChannel, edma_transfer_type_t type, uint32_t srcAddr,
+                                            uint32_t destAddr, edma_transfer_size_t transferSize, uint32_t dataBufferSize)
+{ (void)virtualChannel; (void)type; (void)srcAddr; (void)destAddr; (void)transferSize; (void)dataBufferSize; return STATUS_ERROR; }
+status_t EDMA_DRV_ConfigLoopTransfer(uint8_t virtualChannel, const edma_transfer_config_t *transferConfig)
+{
+    (void)virtualChannel;
+    s_dma_config = *transferConfig;
+    s_dma_loop = *transferConfig->loopTransferConfig;
+    s_dma_config.loopTransferConfig = &s_dma_loop;
+    return STATUS_SUCCESS;
+}
+status_t EDMA_DRV_StartChannel(uint8_t virtualChannel) { (void)virtualChannel; return STATUS_ERROR; }
+status_t EDMA_DRV_StopChannel(uint8_t virtualChannel) { (void)virtualChannel; return STATUS_SUCCESS; }
+void EDMA_DRV_DisableRequestsOnTransferComplete(uint8_t virtualChannel, bool disable) { (void)virtualChannel; (void)disable; }
+void EDMA_DRV_ConfigureInterrupt(uint8_t virtualChannel, edma_channel_interrupt_t intSrc, bool enable)
+{ (void)virtualChannel; (void)intSrc; (void)enable; }
+
+/*
+ * The dispatcher before the rewrite: searches for the lowest set flag with
+ * one register read per mailbox and services that mailbox only. The remote
+ * frame and Rx FIFO branches are left out, nothing here exercises them.
+ */
+static void FLEXCAN_IRQHandlerLegacy(uint8_t instance)
+{
+    uint32_t flag_reg = 0;
+    CAN_Type * base = g_flexcanBase[instance];
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    /* Get the interrupts that are enabled and ready */
+    uint32_t mb_idx = 0;
+    flag_reg = FLEXCAN_GetMsgBuffIntStatusFlag(base, mb_idx);
+
+    while ((flag_reg & 1U) == 0U)
+    {
+        mb_idx++;
+        flag_reg = FLEXCAN_GetMsgBuffIntStatusFlag(base, mb_idx);
+
+        if (mb_idx >= FEATURE_CAN_MAX_MB_NUM)
+        {
+            break;
+        }
+    }
+
+    /* Check Tx/Rx interrupt flag and clear the interrupt (the index bound
+     * only tells the host compiler what the flag read already implies) */
+    if((flag_reg != 0U) && (mb_idx < FEATURE_CAN_MAX_MB_NUM))
+    {
+        if (FLEXCAN_IsRxFifoEnabled(base) && (mb_idx <= FEATURE_CAN_RXFIFO_OVERFLOW))
+        {
+            FLEXCAN_IRQHandlerRxFIFO(instance, mb_idx);
+        }
+        else
+        {
+            /* Check mailbox completed reception */
+            if (state->mbs[mb_idx].state == FLEXCAN_MB_RX_BUSY)
+            {
+                FLEXCAN_IRQHandlerRxMB(instance, mb_idx);
+            }
+        }
+
+        /* Check mailbox completed transmission */
+        if (state->mbs[mb_idx].state == FLEXCAN_MB_TX_BUSY)
+        {
+            FLEXCAN_ClearMsgBuffIntStatusFlag(base, mb_idx);
+            state->mbs[mb_idx].state = FLEXCAN_MB_IDLE;
+
+            /* Invoke callback */
+            if (state->callback != NULL)
+            {
+                state->callback(instance, FLEXCAN_EVENT_TX_COMPLETE, mb_idx, state);
+            }
+
+            if (state->mbs[mb_idx].state == FLEXCAN_MB_IDLE)
+            {
+                /* Complete transmit data */
+                FLEXCAN_CompleteTransfer(instance, mb_idx);
+            }
+        }
+
+        if (FLEXCAN_GetMsgBuffIntStatusFlag(base, mb_idx) != 0U)
+        {
+            if (state->mbs[mb_idx].state == FLEXCAN_MB_IDLE)
+            {
+                /* In case of desynchronized status of the MB to avoid trapping in ISR
+                 * clear the MB flag */
+                FLEXCAN_ClearMsgBuffIntStatusFlag(base, mb_idx);
+            }
+        }
+    }
+}
+
+static void Callback(uint8_t instance, flexcan_event_type_t eventType, uint32_t buffIdx, flexcan_state_t *flexcanState)
+{
+    (void)instance;
+    (void)flexcanState;
+    if ((eventType == FLEXCAN_EVENT_TX_COMPLETE) || (eventType == FLEXCAN_EVENT_RX_COMPLETE))
+    {
+        s_events[buffIdx]++;
+        s_order[s_event_count++] = buffIdx;
+    }
+}
+
+static uint8_t FrameByte(uint32_t mb_idx, uint32_t j)
+{
+    return (uint8_t)((mb_idx * 13U) + j);
+}
+
+/* Mailboxes 31, 30, ... are made ready; even ones receive, odd ones transmit */
+static uint32_t ReadyMask(uint32_t pending)
+{
+    return (pending == 32U) ? 0xFFFFFFFFUL : ~((1UL << (32U - pending)) - 1UL);
+}
+
+static void MakeReady(uint32_t mask)
+{
+    uint32_t mb_idx;
+
+    memset(s_events, 0, sizeof(s_events));
+    s_event_count = 0;
+    for (mb_idx = 0; mb_idx < FEATURE_CAN_MAX_MB_NUM; mb_idx++)
+    {
+        volatile uint32_t *mb = FLEXCAN_GetMsgBuffRegion(CAN0, mb_idx);
+
+        if ((mask & (1UL << mb_idx)) == 0U)
+        {
+            s_state.mbs[mb_idx].state = FLEXCAN_MB_IDLE;
+            continue;
+        }
+        if ((mb_idx & 1U) == 0U)
+        {
+            s_state.mbs[mb_idx].state = FLEXCAN_MB_RX_BUSY;
+            s_state.mbs[mb_idx].mb_message = &s_rx_frames[mb_idx];
+            mb[0] = ((uint32_t)FLEXCAN_RX_FULL << CAN_CS_CODE_SHIFT) | (8UL << CAN_CS_DLC_SHIFT);
+            mb[1] = RX_ID << CAN_ID_STD_SHIFT;
+            mb[2] = ((uint32_t)FrameByte(mb_idx, 0U) << 24) | ((uint32_t)FrameByte(mb_idx, 1U) << 16) |
+                    ((uint32_t)FrameByte(mb_idx, 2U) << 8) | FrameByte(mb_idx, 3U);
+            mb[3] = ((uint32_t)FrameByte(mb_idx, 4U) << 24) | ((uint32_t)FrameByte(mb_idx, 5U) << 16) |
+                    ((uint32_t)FrameByte(mb_idx, 6U) << 8) | FrameByte(mb_idx, 7U);
+        }
+        else
+        {
+            s_state.mbs[mb_idx].state = FLEXCAN_MB_TX_BUSY;
+            mb[0] = (uint32_t)FLEXCAN_TX_INACTIVE << CAN_CS_CODE_SHIFT;
+        }
+    }
+    CAN0->IMASK1 = mask;
+    CAN0->IFLAG1 = mask;
+}
+
+/* Take the interrupt until no enabled flag is left; returns the entries */
+static uint32_t Dispatch(void (*handler)(uint8_t instance))
+{
+    uint32_t entries = 0;
+
+    while (((CAN0->IFLAG1 & CAN0->IMASK1) != 0U) && (entries <= FEATURE_CAN_MAX_MB_NUM))
+    {
+        handler(0U);
+        entries++;
+    }
+    return entries;
+}
+
+static void Verify(const char *name, uint32_t mask)
+{
+    uint32_t mb_idx;
+    uint32_t i;
+
+    CHECK(CAN0->IFLAG1 == 0U, "%s: IFLAG1 0x%08lx left", name, (unsigned long)CAN0->IFLAG1);
+    CHECK(CAN0->IMASK1 == 0U, "%s: IMASK1 0x%08lx left", name, (unsigned long)CAN0->IMASK1);
+    for (mb_idx = 0; mb_idx < FEATURE_CAN_MAX_MB_NUM; mb_idx++)
+    {
+        uint32_t expected = ((mask & (1UL << mb_idx)) != 0U) ? 1U : 0U;
+
+        CHECK(s_events[mb_idx] == expected, "%s: MB %lu has %lu callbacks", name,
+              (unsigned long)mb_idx, (unsigned long)s_events[mb_idx]);
+        CHECK(s_state.mbs[mb_idx].state == FLEXCAN_MB_IDLE, "%s: MB %lu not idle", name, (unsigned long)mb_idx);
+        if ((expected != 0U) && ((mb_idx & 1U) == 0U))
+        {
+            CHECK(s_rx_frames[mb_idx].msgId == RX_ID, "%s: MB %lu id 0x%lx", name,
+                  (unsigned long)mb_idx, (unsigned long)s_rx_frames[mb_idx].msgId);
+            CHECK(s_rx_frames[mb_idx].dataLen == 8U, "%s: MB %lu length %u", name,
+                  (unsigned long)mb_idx, s_rx_frames[mb_idx].dataLen);
+            for (i = 0; i < 8U; i++)
+            {
+                CHECK(s_rx_frames[mb_idx].data[i] == FrameByte(mb_idx, i), "%s: MB %lu byte %lu", name,
+                      (unsigned long)mb_idx, (unsigned long)i);
+            }
+        }
+    }
+    for (i = 1; i < s_event_count; i++)
+    {
+        CHECK(s_order[i - 1U] < s_order[i], "%s: MB %lu serviced before MB %lu", name,
+              (unsigned long)s_order[i - 1U], (unsigned long)s_order[i]);
+    }
+}
+
+typedef struct {
+    uint32_t entries;
+    uint32_t accesses;
+    double ns;
+} result_t;
+
+static result_t Run(const char *name, void (*handler)(uint8_t instance), uint32_t pending)
+{
+    uint32_t mask = ReadyMask(pending);
+    struct timespec start;
+    struct timespec end;
+    result_t result;
+    uint32_t round;
+
+    MakeReady(mask);
+    s_flag_accesses = 0;
+    result.entries = Dispatch(handler);
+    result.accesses = s_flag_accesses;
+    Verify(name, mask);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (round = 0; round < ROUNDS; round++)
+    {
+        CAN0->IMASK1 = mask;
+        CAN0->IFLAG1 = mask;
+        for (uint32_t bits = mask; bits != 0U; bits &= bits - 1U)
+        {
+            uint32_t mb_idx = FLEXCAN_LowestSetBit(bits);
+
+            s_state.mbs[mb_idx].state = ((mb_idx & 1U) == 0U) ? FLEXCAN_MB_RX_BUSY : FLEXCAN_MB_TX_BUSY;
+        }
+        s_event_count = 0;
+        (void)Dispatch(handler);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    result.ns = (((double)(end.tv_sec - start.tv_sec) * 1e9) + (double)(end.tv_nsec - start.tv_nsec)) / ROUNDS;
+    return result;
+}
+
+/*
+ * Rx FIFO ring reader. The simulated channel has moved s_dma_written frames;
+ * frame n goes to entry n % size with ID n and payload words n, ~n as read
+ * from the FIFO output. The half/full interrupt runs the driver callback. The
+ * s_overtake_call-th read of the major loop count first lets the channel move
+ * s_overtake_frames more frames, i.e. while the reader is copying.
+ */
+#define RING_SIZE  (8U)
+
+static flexcan_msgbuff_t s_ring_frames[RING_SIZE];
+static flexcan_rx_fifo_ring_t s_ring;
+static uint32_t s_dma_written = 0;
+static uint32_t s_dma_calls = 0;
+static uint32_t s_overtake_call = 0;
+static uint32_t s_overtake_frames = 0;
+
+static void SimDmaWrite(uint32_t count)
+{
+    while (count-- > 0U)
+    {
+        flexcan_msgbuff_t *entry = &s_ring_frames[s_dma_written % RING_SIZE];
+        uint32_t *data_32 = (uint32_t *)entry->data;
+
+        entry->cs = ((uint32_t)FLEXCAN_RX_FULL << CAN_CS_CODE_SHIFT) | (8UL << CAN_CS_DLC_SHIFT);
+        entry->msgId = (s_dma_written & 0x7FFU) << CAN_ID_STD_SHIFT;
+        data_32[0] = s_dma_written;
+        data_32[1] = ~s_dma_written;
+        s_dma_written++;
+        if ((s_dma_written % (RING_SIZE / 2U)) == 0U)
+        {
+            FLEXCAN_RxFifoRingDMA((void *)0, EDMA_CHN_NORMAL);
+        }
+    }
+}
+
+uint32_t EDMA_DRV_GetRemainingMajorIterationsCount(uint8_t virtualChannel)
+{
+    (void)virtualChannel;
+    if (++s_dma_calls == s_overtake_call)
+    {
+        SimDmaWrite(s_overtake_frames);
+    }
+    return RING_SIZE - (s_dma_written % RING_SIZE);
+}
+
+/* Read up to count frames; expect frames first .. first + n - 1 and the overrun total */
+static void RingRead(const char *name, uint32_t count, uint32_t first, uint32_t n, uint32_t overruns)
+{
+    flexcan_msgbuff_t out[RING_SIZE];
+    uint32_t got;
+    uint32_t i;
+
+    s_dma_calls = 0;
+    got = FLEXCAN_DRV_ReadRxFifoRing(0U, out, count);
+    s_overtake_call = 0;
+    CHECK(got == n, "ring %s: %lu frames, expected %lu", name, (unsigned long)got, (unsigned long)n);
+    for (i = 0; (i < got) && (i < n); i++)
+    {
+        const uint32_t *data_32 = (const uint32_t *)out[i].data;
+        uint32_t k = first + i;
+
+        CHECK((out[i].msgId == (k & 0x7FFU)) && (out[i].dataLen == 8U) &&
+              (data_32[0] == __builtin_bswap32(k)) && (data_32[1] == __builtin_bswap32(~k)),
+              "ring %s: frame %lu is not frame %lu", name, (unsigned long)i, (unsigned long)k);
+    }
+    CHECK(s_ring.overruns == overruns, "ring %s: %lu overruns, expected %lu", name,
+          (unsigned long)s_ring.overruns, (unsigned long)overruns);
+}
+
+static void RunRingRead(void)
+{
+    memset(&s_ring, 0, sizeof(s_ring));
+    s_ring.frames = s_ring_frames;
+    s_ring.size = RING_SIZE;
+    s_state.rxFifoRing = &s_ring;
+    s_dma_written = 0;
+
+    /* Frames show up before the half mark notification */
+    SimDmaWrite(3U);
+    RingRead("partial", 2U, 0U, 2U, 0U);
+    RingRead("normal", RING_SIZE, 2U, 1U, 0U);
+    RingRead("empty", RING_SIZE, 0U, 0U, 0U);
+
+    /* Frames 3-9 sit in entries 3-7 and 0-1 */
+    SimDmaWrite(7U);
+    RingRead("across the wrap", RING_SIZE, 3U, 7U, 0U);
+
+    /* 12 frames behind: resume half a ring behind the writer */
+    SimDmaWrite(12U);
+    RingRead("lapped", RING_SIZE, 18U, 4U, 8U);
+
+    /* Frames 22-27 waiting; 4 more arrive during the copy, the writer then
+     * is on the entry of frame 24 and has rewritten those of 22 and 23 */
+    SimDmaWrite(6U);
+    s_overtake_call = 2U;
+    s_overtake_frames = 4U;
+    RingRead("overtaken during the copy", RING_SIZE, 25U, 3U, 11U);
+    RingRead("after the overtake", RING_SIZE, 28U, 4U, 11U);
+
+    s_state.rxFifoRing = NULL;
+    printf("Rx FIFO ring read: partial, across the wrap, lapped, overtaken during the copy\n");
+}
+
+/*
+ * Transmit priority queue. The simulated controller sends the pending Tx
+ * message buffer with the lowest arbitration key, the lowest mailbox among
+ * equal IDs, then raises its flag and takes the interrupt. Frames carry their
+ * name in the first data byte.
+ */
+#define TXQ_MB_FIRST  (8U)
+#define TXQ_STD(id)   (id), false
+#define TXQ_EXT(id)   (id), true
+
+typedef struct {
+    const char *name;
+    uint32_t id;
+    bool ext;
+} txq_frame_t;
+
+static flexcan_tx_queue_t s_txq;
+static flexcan_tx_entry_t s_txq_entries[16];
+static char s_bus_log[64];
+static uint32_t s_bus_count = 0;
+static const txq_frame_t *s_txq_frames;
+
+static void TxqReset(uint32_t mbMask, uint16_t capacity)
+{
+    uint32_t mb_idx;
+
+    memset(&s_state, 0, sizeof(s_state));
+    memset((void *)CAN0->RAMn, 0, sizeof(CAN0->RAMn));
+    CAN0->IFLAG1 = 0U;
+    CAN0->IMASK1 = 0U;
+    CAN0->MCR = CAN_MCR_MAXMB(FEATURE_CAN_MAX_MB_NUM - 1U);
+    for (mb_idx = 0; mb_idx < FEATURE_CAN_MAX_MB_NUM; mb_idx++)
+    {
+        s_state.mbs[mb_idx].state = FLEXCAN_MB_IDLE;
+    }
+    s_bus_log[0] = '\0';
+    s_bus_count = 0;
+    CHECK(FLEXCAN_DRV_ConfigTxQueue(0U, &s_txq, s_txq_entries, capacity, mbMask) == STATUS_SUCCESS, "txq: config");
+}
+
+static status_t TxqSend(uint8_t tag)
+{
+    flexcan_data_info_t info;
+
+    memset(&info, 0, sizeof(info));
+    info.msg_id_type = s_txq_frames[tag].ext ? FLEXCAN_MSG_ID_EXT : FLEXCAN_MSG_ID_STD;
+    info.data_length = 1U;
+    return FLEXCAN_DRV_SendQueued(0U, &info, s_txq_frames[tag].id, &tag);
+}
+
+/* One frame on the bus; false if no Tx message buffer is pending */
+static bool SimBusSend(void)
+{
+    uint32_t best_key = 0xFFFFFFFFUL;
+    uint32_t best = FEATURE_CAN_MAX_MB_NUM;
+    uint32_t mb_idx;
+    uint32_t other;
+
+    for (mb_idx = 0; mb_idx < FEATURE_CAN_MAX_MB_NUM; mb_idx++)
+    {
+        volatile const uint32_t *mb = FLEXCAN_GetMsgBuffRegion(CAN0, mb_idx);
+        uint32_t key;
+
+        if (((mb[0] & CAN_CS_CODE_MASK) >> CAN_CS_CODE_SHIFT) != (uint32_t)FLEXCAN_TX_DATA)
+        {
+            continue;
+        }
+        key = ((mb[0] & CAN_CS_IDE_MASK) != 0U) ?
+              FLEXCAN_TxArbitrationKey(FLEXCAN_MSG_ID_EXT, mb[1] & (CAN_ID_STD_MASK | CAN_ID_EXT_MASK)) :
+              FLEXCAN_TxArbitrationKey(FLEXCAN_MSG_ID_STD, (mb[1] & CAN_ID_STD_MASK) >> CAN_ID_STD_SHIFT);
+        /* The same ID pending twice is what lets the lowest mailbox reorder them */
+        for (other = 0; other < mb_idx; other++)
+        {
+            volatile const uint32_t *o = FLEXCAN_GetMsgBuffRegion(CAN0, other);
+
+            CHECK(!((((o[0] & CAN_CS_CODE_MASK) >> CAN_CS_CODE_SHIFT) == (uint32_t)FLEXCAN_TX_DATA) &&
+                    ((o[0] & CAN_CS_IDE_MASK) == (mb[0] & CAN_CS_IDE_MASK)) && (o[1] == mb[1])),
+                  "txq: MB %lu and MB %lu both hold ID 0x%lx", (unsigned long)other, (unsigned long)mb_idx,
+                  (unsigned long)mb[1]);
+        }
+        if (key < best_key)
+        {
+            best_key = key;
+            best = mb_idx;
+        }
+    }
+    if (best == FEATURE_CAN_MAX_MB_NUM)
+    {
+        return false;
+    }
+
+    volatile uint32_t *mb = FLEXCAN_GetMsgBuffRegion(CAN0, best);
+    const char *name = s_txq_frames[mb[2] >> 24].name;
+
+    if (s_bus_count != 0U)
+    {
+        (void)strcat(s_bus_log, " ");
+    }
+    (void)strcat(s_bus_log, name);
+    s_bus_count++;
+    mb[0] = (mb[0] & ~CAN_CS_CODE_MASK) | ((uint32_t)FLEXCAN_TX_INACTIVE << CAN_CS_CODE_SHIFT);
+    CAN0->IFLAG1 |= 1UL << best;
+    if ((CAN0->IFLAG1 & CAN0->IMASK1) != 0U)
+    {
+        FLEXCAN_IRQHandler(0U);
+    }
+    return true;
+}
+
+static void TxqRun(const char *name, const char *expected, uint32_t sent, uint32_t rejected)
+{
+    while (SimBusSend())
+    {
+    }
+    CHECK(strcmp(s_bus_log, expected) == 0, "txq %s: bus order \"%s\", expected \"%s\"", name, s_bus_log, expected);
+    CHECK(s_txq.count == 0U, "txq %s: %u frames left in the queue", name, s_txq.count);
+    CHECK(s_txq.sent == sent, "txq %s: sent %lu, expected %lu", name, (unsigned long)s_txq.sent, (unsigned long)sent);
+    CHECK(s_txq.rejected == rejected, "txq %s: rejected %lu, expected %lu", name,
+          (unsigned long)s_txq.rejected, (unsigned long)rejected);
+    CHECK(CAN0->IFLAG1 == 0U, "txq %s: IFLAG1 0x%08lx left", name, (unsigned long)CAN0->IFLAG1);
+    printf("Tx queue, %-28s %s\n", name, s_bus_log);
+}
+
+static void RunTxQueue(void)
+{
+    static const txq_frame_t burst[] = {
+        {"a0", TXQ_STD(0x200U)}, {"a1", TXQ_STD(0x200U)}, {"a2", TXQ_STD(0x200U)},
+        {"b0", TXQ_EXT((0x002UL << 18) | 0x1234U)}, {"c0", TXQ_STD(0x002U)},
+        {"a3", TXQ_STD(0x200U)}, {"a4", TXQ_STD(0x200U)}, {"a5", TXQ_STD(0x200U)},
+        {"d0", TXQ_EXT((0x200UL << 18) | 1U)},
+    };
+    static const txq_frame_t heap[] = {
+        {"f0", TXQ_STD(0x7F0U)}, {"f1", TXQ_STD(0x7F1U)}, {"f2", TXQ_STD(0x7F2U)}, {"f3", TXQ_STD(0x7F3U)},
+        {"e1", TXQ_EXT(0x100UL << 18)}, {"s1", TXQ_STD(0x100U)}, {"p0", TXQ_STD(0x050U)},
+        {"s2", TXQ_STD(0x100U)}, {"e2", TXQ_EXT(0x050UL << 18)}, {"p1", TXQ_STD(0x050U)},
+    };
+    static const txq_frame_t refused[] = {
+        {"x0", TXQ_STD(0x300U)}, {"x1", TXQ_STD(0x301U)}, {"x2", TXQ_STD(0x302U)},
+        {"x3", TXQ_STD(0x303U)}, {"x4", TXQ_STD(0x304U)},
+    };
+    const uint32_t mbs = 0xFUL << TXQ_MB_FIRST;
+    uint8_t tag;
+
+    /* Four free mailboxes, bursts of one ID: one frame of an ID in flight at a time */
+    s_txq_frames = burst;
+    TxqReset(mbs, 16U);
+    for (tag = 0; tag < (uint8_t)(sizeof(burst) / sizeof(burst[0])); tag++)
+    {
+        CHECK(TxqSend(tag) == STATUS_SUCCESS, "txq burst: %s not queued", burst[tag].name);
+    }
+    TxqRun("bursts of one ID:", "c0 b0 a0 a1 a2 a3 a4 a5 d0", 9U, 0U);
+
+    /* All mailboxes busy with f0-f3: the rest leaves the heap in bus priority,
+     * a standard frame before an extended one with the same base ID */
+    s_txq_frames = heap;
+    TxqReset(mbs, 16U);
+    for (tag = 0; tag < (uint8_t)(sizeof(heap) / sizeof(heap[0])); tag++)
+    {
+        CHECK(TxqSend(tag) == STATUS_SUCCESS, "txq heap: %s not queued", heap[tag].name);
+    }
+    TxqRun("priority from the heap:", "f0 p0 p1 e2 s1 s2 e1 f1 f2 f3", 10U, 0U);
+
+    /* Queue of 2 behind two mailboxes, MB 9 above MAXMB: the controller refuses
+     * x1, x2 and later x4 loaded into it, and a third frame finds the queue full */
+    s_txq_frames = refused;
+    TxqReset(0x3UL << TXQ_MB_FIRST, 2U);
+    CAN0->MCR = CAN_MCR_MAXMB(TXQ_MB_FIRST);
+    CHECK(TxqSend(0U) == STATUS_SUCCESS, "txq refused: x0 not queued");
+    CHECK(TxqSend(1U) == STATUS_SUCCESS, "txq refused: x1 not queued");
+    CHECK(TxqSend(2U) == STATUS_SUCCESS, "txq refused: x2 not queued");
+    s_state.mbs[TXQ_MB_FIRST + 1U].state = FLEXCAN_MB_TX_BUSY;  // Hold MB 9 so x3 and x4 wait
+    CHECK(TxqSend(3U) == STATUS_SUCCESS, "txq refused: x3 not queued");
+    CHECK(TxqSend(4U) == STATUS_SUCCESS, "txq refused: x4 not queued");
+    CHECK(TxqSend(0U) == STATUS_BUSY, "txq refused: queue not full");
+    s_state.mbs[TXQ_MB_FIRST + 1U].state = FLEXCAN_MB_IDLE;
+    TxqRun("full queue and refusals:", "x0 x3", 2U, 4U);
+
+    s_state.txQueue = NULL;
+}
+
+/*
+ * Continuous receive. Frame n arrives in the armed mailbox with ID n and data
+ * words n and ~n and takes the interrupt if it is enabled.
+ */
+#define RXQ_MB    (12U)
+#define RXQ_SIZE  (4U)
+
+static flexcan_rx_queue_t s_rxq;
+static flexcan_msgbuff_t s_rxq_frames[RXQ_SIZE];
+static uint32_t s_rxq_events = 0;
+static uint32_t s_rxq_next = 0;
+
+static void RxqCallback(uint8_t instance, flexcan_event_type_t eventType, uint32_t buffIdx,
+                        flexcan_state_t *flexcanState)
+{
+    (void)instance;
+    (void)flexcanState;
+    CHECK((eventType == FLEXCAN_EVENT_RX_COMPLETE) && (buffIdx == RXQ_MB), "rxq: event %d on MB %lu",
+          (int)eventType, (unsigned long)buffIdx);
+    s_rxq_events++;
+}
+
+static void SimRxFrame(void)
+{
+    volatile uint32_t *mb = FLEXCAN_GetMsgBuffRegion(CAN0, RXQ_MB);
+    uint32_t n = s_rxq_next++;
+
+    mb[0] = ((uint32_t)FLEXCAN_RX_FULL << CAN_CS_CODE_SHIFT) | (8UL << CAN_CS_DLC_SHIFT);
+    mb[1] = (n << CAN_ID_STD_SHIFT) & CAN_ID_STD_MASK;
+    mb[2] = n;
+    mb[3] = ~n;
+    CAN0->IFLAG1 |= 1UL << RXQ_MB;
+    if ((CAN0->IFLAG1 & CAN0->IMASK1) != 0U)
+    {
+        FLEXCAN_IRQHandler(0U);
+    }
+}
+
+static void RxqArm(void)
+{
+    memset(&s_state, 0, sizeof(s_state));
+    memset((void *)CAN0->RAMn, 0, sizeof(CAN0->RAMn));
+    CAN0->IFLAG1 = 0U;
+    CAN0->IMASK1 = 0U;
+    CAN0->MCR = CAN_MCR_MAXMB(FEATURE_CAN_MAX_MB_NUM - 1U);
+    s_state.callback = RxqCallback;
+    s_rxq_events = 0;
+    s_rxq_next = 0;
+    CHECK(FLEXCAN_DRV_ReceiveContinuous(0U, RXQ_MB, &s_rxq, s_rxq_frames, RXQ_SIZE) == STATUS_SUCCESS,
+          "rxq: arm");
+}
+
+/* Read up to count frames and expect n of them, frames first, first + 1, ... */
+static void RxqRead(const char *name, uint32_t count, uint32_t first, uint32_t n)
+{
+    flexcan_msgbuff_t out[RXQ_SIZE * 2U];
+    uint32_t got = FLEXCAN_DRV_ReadRxQueue(0U, RXQ_MB, out, count);
+    uint32_t i;
+
+    CHECK(got == n, "rxq %s: read %lu frames, expected %lu", name, (unsigned long)got, (unsigned long)n);
+    for (i = 0; (i < got) && (i < n); i++)
+    {
+        uint32_t id = (first + i) & (CAN_ID_STD_MASK >> CAN_ID_STD_SHIFT);
+        uint32_t word;
+
+        (void)memcpy(&word, &out[i].data[0], sizeof(word));
+        CHECK((out[i].msgId == id) && (out[i].dataLen == 8U) && (word == __builtin_bswap32(first + i)),
+              "rxq %s: frame %lu id 0x%lx", name, (unsigned long)i, (unsigned long)out[i].msgId);
+    }
+}
+
+static void RxqState(const char *name, uint32_t received, uint32_t overflows)
+{
+    CHECK(s_rxq.received == received, "rxq %s: received %lu, expected %lu", name,
+          (unsigned long)s_rxq.received, (unsigned long)received);
+    CHECK(s_rxq.overflows == overflows, "rxq %s: overflows %lu, expected %lu", name,
+          (unsigned long)s_rxq.overflows, (unsigned long)overflows);
+    CHECK(s_rxq_events == received, "rxq %s: %lu callbacks for %lu frames", name,
+          (unsigned long)s_rxq_events, (unsigned long)received);
+    CHECK((CAN0->IFLAG1 & (1UL << RXQ_MB)) == 0U, "rxq %s: flag left set", name);
+}
+
+static void RunRxQueue(void)
+{
+    uint32_t i;
+
+    /* Two frames past a full queue are dropped, the mailbox stays armed */
+    RxqArm();
+    for (i = 0; i < RXQ_SIZE + 2U; i++)
+    {
+        SimRxFrame();
+    }
+    RxqState("full", RXQ_SIZE, 2U);
+    CHECK(((CAN0->IMASK1 & (1UL << RXQ_MB)) != 0U) && (s_state.mbs[RXQ_MB].state == FLEXCAN_MB_RX_BUSY),
+          "rxq full: mailbox disarmed");
+    RxqRead("full", RXQ_SIZE * 2U, 0U, RXQ_SIZE);
+    SimRxFrame();
+    RxqRead("after full", RXQ_SIZE, RXQ_SIZE + 2U, 1U);
+    RxqState("after full", RXQ_SIZE + 1U, 2U);
+
+    /* head and tail wrap at 65536; the queue fills and drops across the wrap */
+    RxqArm();
+    for (i = 0; i < 0xFFFEUL; i += 2U)
+    {
+        SimRxFrame();
+        SimRxFrame();
+        RxqRead("wrap", 2U, i, 2U);
+    }
+    for (i = 0; i <= RXQ_SIZE; i++)
+    {
+        SimRxFrame();
+    }
+    CHECK(s_rxq.head == 2U, "rxq wrap: head %u", s_rxq.head);
+    RxqState("wrap", 0xFFFEUL + RXQ_SIZE, 1U);
+    RxqRead("wrap", 1U, 0xFFFEUL, 1U);
+    RxqRead("wrap", RXQ_SIZE, 0xFFFFUL, RXQ_SIZE - 1U);
+    CHECK(s_rxq.tail == 2U, "rxq wrap: tail %u", s_rxq.tail);
+    RxqRead("wrap, empty", RXQ_SIZE, 0U, 0U);
+
+    /* Frames queued before an abort are still read; a frame after it is not taken */
+    RxqArm();
+    for (i = 0; i < 3U; i++)
+    {
+        SimRxFrame();
+    }
+    CHECK(FLEXCAN_DRV_AbortTransfer(0U, RXQ_MB) == STATUS_SUCCESS, "rxq abort: abort");
+    CHECK(((CAN0->IMASK1 & (1UL << RXQ_MB)) == 0U) && (s_state.mbs[RXQ_MB].state == FLEXCAN_MB_IDLE),
+          "rxq abort: mailbox still armed");
+    SimRxFrame();
+    RxqRead("after abort", 2U, 0U, 2U);
+    RxqRead("after abort", RXQ_SIZE, 2U, 1U);
+    RxqRead("after abort, empty", RXQ_SIZE, 0U, 0U);
+    CHECK((s_rxq.received == 3U) && (s_rxq_events == 3U), "rxq abort: received %lu",
+          (unsigned long)s_rxq.received);
+    CAN0->IFLAG1 = 0U;
+    RxqArm();
+    RxqRead("armed again", RXQ_SIZE, 0U, 0U);
+
+    s_state.callback = NULL;
+    printf("Rx queue: full, 16-bit head/tail wrap, read after abort\n");
+}
+
+static void RunDispatchers(void)
+{
+    static const uint32_t pending[] = {1U, 2U, 4U, 8U, 16U, 32U};
+    uint32_t i;
+
+    printf("pending | entries old new | IFLAG/IMASK accesses old new | host ns per batch old new\n");
+    for (i = 0; i < (sizeof(pending) / sizeof(pending[0])); i++)
+    {
+        result_t legacy = Run("legacy", FLEXCAN_IRQHandlerLegacy, pending[i]);
+        result_t current = Run("current", FLEXCAN_IRQHandler, pending[i]);
+
+        CHECK(legacy.entries == pending[i], "legacy: %lu entries for %lu mailboxes",
+              (unsigned long)legacy.entries, (unsigned long)pending[i]);
+        CHECK(current.entries == 1U, "current: %lu entries for %lu mailboxes",
+              (unsigned long)current.entries, (unsigned long)pending[i]);
+        CHECK(current.accesses < legacy.accesses, "current: %lu accesses, legacy %lu",
+              (unsigned long)current.accesses, (unsigned long)legacy.accesses);
+        printf("%7lu | %7lu %3lu | %24lu %4lu | %21.0f %4.0f\n", (unsigned long)pending[i],
+               (unsigned long)legacy.entries, (unsigned long)current.entries,
+               (unsigned long)legacy.accesses, (unsigned long)current.accesses, legacy.ns, current.ns);
+    }
+}
+
+/*
+ * Rx FIFO ring channel: replays the recorded TCD the way the eDMA runs it.
+ * Every minor loop writes the 16 bytes of one frame; the minor loop offset
+ * follows all of them but the last, which takes DLAST instead. Three laps
+ * must write exactly the first 16 bytes of each entry, in order, and come
+ * back to the start of the ring.
+ */
+static void RunRingTcd(uint16_t size)
+{
+    static flexcan_msgbuff_t frames[64];
+    flexcan_rx_fifo_ring_t ring;
+    uint32_t start;
+    uint32_t daddr;
+    uint32_t bad = 0;
+    uint32_t lap;
+    uint32_t n;
+    uint32_t w;
+
+    memset(&ring, 0, sizeof(ring));
+    ring.frames = frames;
+    ring.size = size;
+    s_state.rxFifoRing = &ring;
+    CHECK(FLEXCAN_ConfigRxFifoRingDMA(0U) == STATUS_SUCCESS, "ring %u: channel not configured", size);
+    s_state.rxFifoRing = NULL;
+
+    CHECK(s_dma_loop.majorLoopIterationCount == size, "ring %u: %lu major iterations", size,
+          (unsigned long)s_dma_loop.majorLoopIterationCount);
+    CHECK(s_dma_config.minorByteTransferCount == FLEXCAN_RXFIFO_FRAME_BYTES, "ring %u: %lu bytes per request", size,
+          (unsigned long)s_dma_config.minorByteTransferCount);
+    CHECK((s_dma_config.srcModulo == EDMA_MODULO_16B) && (s_dma_config.srcLastAddrAdjust == 0),
+          "ring %u: source leaves the FIFO output window", size);
+    CHECK(s_dma_config.destTransferSize == EDMA_TRANSFER_SIZE_4B, "ring %u: destination size", size);
+
+    start = s_dma_config.destAddr;
+    daddr = start;
+    for (lap = 0; lap < 3U; lap++)
+    {
+        for (n = 0; n < s_dma_loop.majorLoopIterationCount; n++)
+        {
+            for (w = 0; w < (s_dma_config.minorByteTransferCount / 4U); w++)
+            {
+                if ((daddr - start) != ((n * sizeof(flexcan_msgbuff_t)) + (w * 4U)))
+                {
+                    bad++;
+                }
+                daddr += (uint32_t)s_dma_config.destOffset;
+            }
+            if ((n + 1U) < s_dma_loop.majorLoopIterationCount)
+            {
+                daddr += s_dma_loop.dstOffsetEnable ? (uint32_t)s_dma_loop.minorLoopOffset : 0U;
+            }
+            else
+            {
+                daddr += (uint32_t)s_dma_config.destLastAddrAdjust;
+            }
+        }
+        CHECK(daddr == start, "ring %u: lap %lu ends %ld bytes off the ring start", size,
+              (unsigned long)lap, (long)(int32_t)(daddr - start));
+    }
+    CHECK(bad == 0U, "ring %u: %lu writes off their entry", size, (unsigned long)bad);
+}
+
+int main(void)
+{
+    uint16_t size;
+
+    g_flexcanStatePtr[0] = &s_state;
+    s_state.callback = Callback;
+    CAN0->MCR = CAN_MCR_MAXMB(FEATURE_CAN_MAX_MB_NUM - 1U);
+
+    RunDispatchers();
+    for (size = 2U; size <= 64U; size *= 2U)
+    {
+        RunRingTcd(size);
+    }
+    printf("Rx FIFO ring TCD: sizes 2-64, 3 laps, every write inside its entry\n");
+    RunRingRead();
+    RunTxQueue();
+    RunRxQueue();
+
+    printf("%s\n", (s_failures == 0U) ? "PASS" : "FAILED");
+    return (s_failures == 0U) ? 0 : 1;
+}
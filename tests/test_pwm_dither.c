@@ -0,0 +1,150 @@
+/*
+ * Can_Receive software PWM dithering (PWM_UpdateDutyFine_rs) and duty
+ * ramps (PWM_RampDuty_rs) against a simulated FTM0.
+ *
+ * Each simulated PWM period starts at the reload point: a pending software
+ * trigger loads the buffered CnV into the active duty, then the reload
+ * interrupt runs and writes the value for the next period. The averaged
+ * duty over N periods is compared with duty + frac/256. Checked:
+ *   - every period outputs duty or duty + 1 tick;
+ *   - the summed error after any N periods stays below 1 tick, so the
+ *     averaged error is below 1/N tick, and is exactly 0 every 256 periods;
+ *   - a full-scale ramp at MOD = 0xFFFF is monotonic and lands on target.
+ */
+#include <stdio.h>
+#include "sim_device.h"
+#include "s32_core_cm4.h"
+
+#include "pwm.c"
+
+#define INSTANCE   (0U)
+#define CHANNEL    (0U)
+#define PERIODS    (4096UL)
+
+static FTM_Type g_sim_ftm[FTM_INSTANCE_COUNT];
+FTM_Type * const g_ftmBase[FTM_INSTANCE_COUNT] = {
+    &g_sim_ftm[0], &g_sim_ftm[1], &g_sim_ftm[2], &g_sim_ftm[3]
+};
+
+static uint32_t s_active = 0;   // CnV in effect for the current period
+static uint32_t s_failures = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)) { s_failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+                              printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+status_t FTM_DRV_SetSync(uint32_t instance, const ftm_pwm_sync_t *param) {
+    (void)instance;
+    (void)param;
+    return STATUS_SUCCESS;
+}
+
+status_t FTM_DRV_FastUpdatePwmChannels(uint32_t instance, uint8_t numberOfChannels, const uint8_t *channels,
+                                       const uint16_t *duty, bool softwareTrigger) {
+    uint8_t i;
+
+    for (i = 0; i < numberOfChannels; i++) {
+        g_ftmBase[instance]->CONTROLS[channels[i]].CnV = duty[i];
+    }
+    if (softwareTrigger) {
+        g_ftmBase[instance]->SYNC |= FTM_SYNC_SWSYNC_MASK;
+    }
+    return STATUS_SUCCESS;
+}
+
+/* Reload point: latch the buffered CnV, then take the reload interrupt */
+static uint32_t SimPeriod(void) {
+    FTM_Type *ftm = g_ftmBase[INSTANCE];
+
+    if ((ftm->SYNC & FTM_SYNC_SWSYNC_MASK) != 0U) {
+        s_active = ftm->CONTROLS[CHANNEL].CnV;
+        ftm->SYNC &= ~FTM_SYNC_SWSYNC_MASK;
+    }
+    ftm->SC |= FTM_SC_RF_MASK;
+    if ((ftm->SC & FTM_SC_RIE_MASK) != 0U) {
+        FTM0_Ovf_Reload_IRQHandler();
+    }
+    return s_active;
+}
+
+/* Fine duty d + f/256 for PERIODS periods; returns the worst summed error in 1/256 tick */
+static uint32_t RunDither(uint16_t mod, uint16_t duty, uint8_t frac) {
+    uint32_t fine = ((uint32_t)duty << PWM_FRAC_BITS) | frac;
+    uint64_t sum = 0;
+    uint32_t worst = 0;
+    uint32_t n;
+
+    CHECK(PWM_UpdateDutyFine_rs(INSTANCE, CHANNEL, fine) == STATUS_SUCCESS, "fine duty %lu", (unsigned long)fine);
+    (void)SimPeriod(); // The first period still runs the previous duty
+    for (n = 1; n <= PERIODS; n++) {
+        uint32_t active = SimPeriod();
+        uint64_t expected = (uint64_t)n * fine;
+        uint64_t got = sum + ((uint64_t)active << PWM_FRAC_BITS);
+        uint32_t err = (uint32_t)((got > expected) ? (got - expected) : (expected - got));
+
+        sum = got;
+        CHECK((active == duty) || (active == (uint32_t)duty + 1U),
+              "MOD %u duty %u + %u/256: period %lu outputs %lu", mod, duty, frac, (unsigned long)n, (unsigned long)active);
+        CHECK(err < (1UL << PWM_FRAC_BITS), "MOD %u duty %u + %u/256: error %lu/256 tick after %lu periods",
+              mod, duty, frac, (unsigned long)err, (unsigned long)n);
+        CHECK(((n % 256UL) != 0UL) || (err == 0UL), "MOD %u duty %u + %u/256: average not exact after %lu periods",
+              mod, duty, frac, (unsigned long)n);
+        if (err > worst) {
+            worst = err;
+        }
+    }
+    return worst;
+}
+
+static void RunDitherSweep(uint16_t mod) {
+    const uint16_t duties[] = {0U, 1U, (uint16_t)(mod / 2U), (uint16_t)(mod - 1U)};
+    uint32_t worst = 0;
+    uint32_t i;
+    uint32_t f;
+
+    CHECK(PWM_Init_Register(INSTANCE, mod, 1U << CHANNEL) == STATUS_SUCCESS, "init MOD %u", mod);
+    for (i = 0; i < (sizeof(duties) / sizeof(duties[0])); i++) {
+        for (f = 1; f < (1UL << PWM_FRAC_BITS); f++) {
+            uint32_t err = RunDither(mod, duties[i], (uint8_t)f);
+
+            if (err > worst) {
+                worst = err;
+            }
+        }
+    }
+    printf("dither MOD %5u: 4 duties x 255 fractions x %lu periods, worst summed error %3lu/256 tick\n",
+           mod, (unsigned long)PERIODS, (unsigned long)worst);
+}
+
+static void RunRamp(uint16_t from, uint16_t to, uint16_t periods) {
+    uint32_t prev;
+    uint32_t n;
+
+    CHECK(PWM_Init_Register(INSTANCE, 0xFFFFU, 1U << CHANNEL) == STATUS_SUCCESS, "init MOD 0xFFFF");
+    (void)SimPeriod(); // Let the trigger left by the previous run load
+    CHECK(PWM_RampDuty_rs(INSTANCE, CHANNEL, from, 0U) == STATUS_SUCCESS, "set %u", from);
+    prev = SimPeriod();
+    CHECK(prev == from, "start duty %lu, expected %u", (unsigned long)prev, from);
+    CHECK(PWM_RampDuty_rs(INSTANCE, CHANNEL, to, periods) == STATUS_SUCCESS, "ramp to %u", to);
+    (void)SimPeriod(); // The step written here is loaded at the next reload
+    for (n = 0; n < periods; n++) {
+        uint32_t active = SimPeriod();
+
+        CHECK((to >= from) ? (active >= prev) : (active <= prev), "ramp %u -> %u: period %lu goes %lu -> %lu",
+              from, to, (unsigned long)n, (unsigned long)prev, (unsigned long)active);
+        prev = active;
+    }
+    CHECK(prev == to, "ramp %u -> %u ends at %lu", from, to, (unsigned long)prev);
+    CHECK(!PWM_RampBusy(INSTANCE, CHANNEL), "ramp %u -> %u still busy", from, to);
+    printf("ramp  MOD 65535: %5u -> %5u over %u periods\n", from, to, periods);
+}
+
+int main(void) {
+    RunDitherSweep(399U);    // 20 kHz on an 8 MHz clock
+    RunDitherSweep(0xFFFFU);
+    RunRamp(0U, 0xFFFFU, 1000U);
+    RunRamp(0xFFFFU, 0U, 1000U);
+    RunRamp(100U, 0xFF00U, 3U);
+
+    printf("%s\n", (s_failures == 0U) ? "PASS" : "FAILED");
+    return (s_failures == 0U) ? 0 : 1;
+}
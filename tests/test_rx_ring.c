@@ -0,0 +1,190 @@
+/*
+ * Can_Receive receive ring (FLEXCAN0_rx_isr) against a simulated CAN0.
+ *
+ * Frames arrive back to back at 500 kbit/s with no stuff bits, the
+ * shortest spacing the bus allows. The RX interrupt is taken after every
+ * frame and the main loop drains the ring periodically. Checked:
+ *   - no loss, in order, exact payloads and 32-bit timestamps across
+ *     many FlexCAN timer wraps while the drain period stays within
+ *     (ring size - 1) frame times;
+ *   - a longer drain period drops exactly the frames that did not fit
+ *     and counts them as software overruns;
+ *   - a frame overwritten while the interrupt was masked is counted as a
+ *     hardware overrun.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "sim_device.h"
+
+#define RING_BARRIER() __sync_synchronize()
+#include "FlexCAN.c"
+
+#define BITRATE          (500000UL)
+#define FRAME_COUNT      (20000UL)
+#define RING_USABLE      (FLEXCAN0_RX_RING_SIZE - 1UL)
+/* IFLAG1 bit set with every delivered frame; the ISR's write-1-to-clear of
+ * the RX flag overwrites IFLAG1 and drops it, that is how the simulation
+ * sees the acknowledge */
+#define SIM_PENDING      (1UL << 31)
+
+static uint32_t s_bus_time = 0;           // Bit times since the start
+static uint32_t s_arrival[FRAME_COUNT];   // Extended time each frame ended
+static uint32_t s_failures = 0;
+static bool s_empty_frames = false;       // Send only 0-byte frames, the shortest
+
+#define CHECK(cond, ...) do { if (!(cond)) { s_failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+                              printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+/* Standard data frame with len bytes, no stuff bits, plus 3 bits interframe space */
+static uint32_t FrameBits(uint32_t len) {
+    return 47UL + (8UL * len);
+}
+
+static uint8_t FrameLen(uint32_t k) {
+    return s_empty_frames ? 0U : (uint8_t)(k % 9UL);
+}
+
+static uint8_t FrameByte(uint32_t k, uint32_t j) {
+    return (uint8_t)((k * 7UL) + j);
+}
+
+/* The controller stores frame k into the RX mailbox */
+static void SimReceive(uint32_t k, uint8_t len) {
+    volatile uint32_t *mb = &CAN0->RAMn[RX_MAILBOX * MSG_BUF_SIZE];
+    uint32_t code = ((CAN0->IFLAG1 & (1UL << RX_MAILBOX)) != 0UL) ? MB_CODE_RX_OVRN : MB_CODE_RX_FULL;
+    uint32_t w;
+
+    s_bus_time += FrameBits(len);
+    s_arrival[k] = s_bus_time;
+    for (w = 0; w < 2U; w++) {
+        uint32_t j = w << 2;
+        mb[2 + w] = ((uint32_t)((j + 0U) < len ? FrameByte(k, j + 0U) : 0U) << 24) |
+                    ((uint32_t)((j + 1U) < len ? FrameByte(k, j + 1U) : 0U) << 16) |
+                    ((uint32_t)((j + 2U) < len ? FrameByte(k, j + 2U) : 0U) << 8) |
+                    ((uint32_t)((j + 3U) < len ? FrameByte(k, j + 3U) : 0U));
+    }
+    mb[1] = RX_MSG_ID << 18;
+    mb[0] = (code << MB_CODE_SHIFT) | ((uint32_t)len << CAN_WMBn_CS_DLC_SHIFT) | (s_bus_time & MB_TIMESTAMP_MASK);
+    CAN0->TIMER = s_bus_time & 0xFFFFUL;
+    CAN0->IFLAG1 = (1UL << RX_MAILBOX) | SIM_PENDING;
+}
+
+/* Take the RX interrupt; emulate the write-1-to-clear it did */
+static void SimInterrupt(void) {
+    if (SIM_Irq(CAN0_ORed_0_15_MB_IRQn) && ((CAN0->IFLAG1 & SIM_PENDING) == 0UL)) {
+        CAN0->IFLAG1 = 0;
+    }
+}
+
+/* FLEXCAN0_enable_rx_irq() clears the RX flag by writing 1, apply that here */
+static void EnableRx(void) {
+    FLEXCAN0_enable_rx_irq();
+    CAN0->IFLAG1 = 0;
+}
+
+/* Main loop: read everything; expect the frames of accepted[] in order */
+static uint32_t Drain(const bool *accepted, uint32_t *next) {
+    flexcan_frame_t frame;
+    uint32_t count = 0;
+
+    while (FLEXCAN0_read_frame(&frame)) {
+        uint32_t k = *next;
+        uint32_t j;
+
+        while (!accepted[k]) {
+            k++;
+        }
+        *next = k + 1U;
+        count++;
+
+        CHECK(frame.id == RX_MSG_ID, "frame %lu: id %lu", (unsigned long)k, (unsigned long)frame.id);
+        CHECK(frame.len == FrameLen(k), "frame %lu: len %u", (unsigned long)k, frame.len);
+        CHECK(frame.timestamp == s_arrival[k], "frame %lu: timestamp %lu, expected %lu",
+              (unsigned long)k, (unsigned long)frame.timestamp, (unsigned long)s_arrival[k]);
+        for (j = 0; j < FLEXCAN0_PAYLOAD_SIZE; j++) {
+            uint8_t expected = (j < frame.len) ? FrameByte(k, j) : 0U;
+            CHECK(frame.data[j] == expected, "frame %lu: byte %lu", (unsigned long)k, (unsigned long)j);
+        }
+    }
+    return count;
+}
+
+/*
+ * FRAME_COUNT frames at full load, draining every drain_bits bit times.
+ * The model tracks ring occupancy to know which frames must be dropped.
+ */
+static void RunLoad(const char *name, uint32_t drain_bits, bool empty_frames, bool expect_loss) {
+    static bool accepted[FRAME_COUNT + 1U];
+    flexcan_rx_overrun_t overrun;
+    uint32_t last_drain = s_bus_time;
+    uint32_t occupancy = 0;
+    uint32_t dropped = 0;
+    uint32_t next = 0;
+    uint32_t read = 0;
+    uint32_t k;
+
+    s_empty_frames = empty_frames;
+    EnableRx();
+    for (k = 0; k < FRAME_COUNT; k++) {
+        if ((s_bus_time - last_drain) >= drain_bits) {
+            read += Drain(accepted, &next);
+            occupancy = 0;
+            last_drain = s_bus_time;
+        }
+        SimReceive(k, FrameLen(k));
+        SimInterrupt();
+        accepted[k] = occupancy < RING_USABLE;
+        if (accepted[k]) {
+            occupancy++;
+        } else {
+            dropped++;
+        }
+    }
+    accepted[FRAME_COUNT] = true;
+    read += Drain(accepted, &next);
+
+    FLEXCAN0_get_rx_overrun(&overrun);
+    CHECK(overrun.hw == 0U, "%s: hw overrun %lu", name, (unsigned long)overrun.hw);
+    CHECK(overrun.sw == dropped, "%s: sw overrun %lu, expected %lu", name,
+          (unsigned long)overrun.sw, (unsigned long)dropped);
+    CHECK(read + dropped == FRAME_COUNT, "%s: %lu read + %lu dropped", name,
+          (unsigned long)read, (unsigned long)dropped);
+    CHECK((dropped != 0U) == expect_loss, "%s: %lu dropped", name, (unsigned long)dropped);
+    printf("%-34s drain every %4lu bits (%5.2f ms): %lu frames, %lu dropped, %lu timer wraps\n",
+           name, (unsigned long)drain_bits, (drain_bits * 1000.0) / BITRATE, (unsigned long)FRAME_COUNT,
+           (unsigned long)dropped, (unsigned long)(s_bus_time >> 16));
+}
+
+static void RunMaskedInterrupt(void) {
+    static const bool all[3] = {true, true, true};
+    flexcan_rx_overrun_t overrun;
+    flexcan_frame_t frame;
+    uint32_t next = 1;
+
+    s_empty_frames = false;
+    EnableRx();
+    INT_SYS_DisableIRQ(CAN0_ORed_0_15_MB_IRQn);
+    SimReceive(0, FrameLen(0));
+    SimReceive(1, FrameLen(1)); // overwrites frame 0
+    INT_SYS_EnableIRQ(CAN0_ORed_0_15_MB_IRQn);
+    SimInterrupt();
+
+    FLEXCAN0_get_rx_overrun(&overrun);
+    CHECK(overrun.hw == 1U, "masked: hw overrun %lu", (unsigned long)overrun.hw);
+    CHECK(Drain(all, &next) == 1U, "masked: one frame expected");
+    CHECK(!FLEXCAN0_read_frame(&frame), "masked: ring not empty");
+    printf("%-34s hw overrun counted\n", "masked interrupt");
+}
+
+int main(void) {
+    /* Drain deadline: the ring holds RING_USABLE of the shortest frames */
+    uint32_t deadline = RING_USABLE * FrameBits(0);
+
+    RunLoad("mixed lengths, within deadline", deadline, false, false);
+    RunLoad("empty frames, at deadline", deadline, true, false);
+    RunLoad("empty frames, past deadline", deadline + (2U * FrameBits(0)), true, true);
+    RunMaskedInterrupt();
+
+    printf("%s\n", (s_failures == 0U) ? "PASS" : "FAILED");
+    return (s_failures == 0U) ? 0 : 1;
+}